@@ -1,6 +1,11 @@
 
 //!  Constants containing file
- 
+
+#ifndef CONSTANTS_H
+#define CONSTANTS_H
+
+#include <math.h>
+
 const double C=1; //!< The capacity
 const double Delay=1.5; //!< Delay for the transmission of a spike between pre- and postsynaptic neurons in [mS]
 const double epsilon = 0.1; //!< constant << 1 : Ce = epsilon * Ne, Ci = epsilon * Ni
@@ -16,3 +21,5 @@ const double scalarCste1 = exp(-h/tau); //!< Used in the membrane equation
 const double scalarCste2 = R*(1-scalarCste1); //!< Used in the membrane equation
 const unsigned int threshold=20; //!< Threshold beyond which the presynaptic will spike [mV]
 const unsigned int Vreset=0; //!< The membrane potential reset to 0 [mV] after the refractory time
+
+#endif
@@ -0,0 +1,96 @@
+#include "backgroundNoise.hpp"
+#include <cassert>
+#include <math.h>
+
+BackgroundNoise::BackgroundNoise(double const& mean, uint64_t const& seed, uint64_t const& stream)
+: mean_(mean), generator_(seed, stream)
+{
+    assert(mean_ >= 0);
+
+    //Probabilities of 0, 1, 2, ... spikes, until the rest is negligible
+    std::vector<long double> probabilities(1, expl(-static_cast<long double>(mean_)));
+    long double total(probabilities[0]);
+    while(1 - total > 1E-18L and probabilities.size() < (1u << 16)){
+        probabilities.push_back(probabilities.back()*mean_/probabilities.size());
+        total += probabilities.back();
+    }
+    //The negligible tail is given to the last case
+    probabilities.back() += 1 - total;
+
+    //The size of the table is a power of 2 (at least 2), the cases that are added have a probability of 0
+    size_t size(2);
+    shift_ = 63;
+    while(size < probabilities.size()){
+        size *= 2;
+        --shift_;
+    }
+    probabilities.resize(size, 0);
+    fractionMask_ = (uint64_t(1) << shift_) - 1;
+
+    //Vose's algorithm : each case is filled up to 1/size by its own probability and its alias
+    thresholds_.assign(size, 0);
+    alias_.assign(size, 0);
+    std::vector<long double> scaled(size);
+    std::vector<uint32_t> small, large;
+    for(size_t k(0) ; k < size ; ++k){
+        scaled[k] = probabilities[k]*size;
+        if(scaled[k] < 1)
+            small.push_back(k);
+        else
+            large.push_back(k);
+    }
+
+    while(!small.empty() and !large.empty()){
+        uint32_t s(small.back()), l(large.back());
+        small.pop_back();
+        large.pop_back();
+
+        thresholds_[s] = static_cast<uint64_t>(scaled[s]*(fractionMask_ + 1.0L));
+        alias_[s] = l;
+
+        //The large case gives the rest of the small case
+        scaled[l] -= 1 - scaled[s];
+        if(scaled[l] < 1)
+            small.push_back(l);
+        else
+            large.push_back(l);
+    }
+
+    //The cases left are full (up to the rounding errors) : they always return themselves
+    for(auto k : small){
+        thresholds_[k] = fractionMask_ + 1;
+        alias_[k] = k;
+    }
+    for(auto k : large){
+        thresholds_[k] = fractionMask_ + 1;
+        alias_[k] = k;
+    }
+}
+
+double BackgroundNoise::getMean() const{
+
+    return mean_;
+}
+
+size_t BackgroundNoise::getTableSize() const{
+
+    return thresholds_.size();
+}
+
+Xoshiro256& BackgroundNoise::getGenerator(){
+
+    return generator_;
+}
+
+Xoshiro256 const& BackgroundNoise::getGenerator() const{
+
+    return generator_;
+}
+
+/*********************************************************************/
+
+void BackgroundNoise::fill(unsigned int* counts, size_t const& nb){
+
+    for(size_t i(0) ; i < nb ; ++i)
+        counts[i] = (*this)();
+}
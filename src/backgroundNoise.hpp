@@ -0,0 +1,84 @@
+#ifndef BACKGROUND_NOISE_H
+#define BACKGROUND_NOISE_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "xoshiro256.hpp"
+
+
+//!  Class BackgroundNoise
+/*!
+ This class draws the number of spikes the Cext artificial neurons send to one neuron during one timeStep : a Poisson distribution of mean Vext*h, which is the same for the whole simulation.
+
+ Because the mean never changes, the distribution is precomputed once in an alias table (Walker/Vose) of size K, a power of 2 : the probabilities of 0 to K-1 spikes (the tail, smaller than 1E-18, is given to the last case).
+ A draw takes one number of the generator xoshiro256** : its log2(K) highest bits choose a case of the table, the other bits are compared with the threshold of the case to return the case or its alias. There is no loop and no call to exp or log, unlike std::poisson_distribution.
+ */
+
+class BackgroundNoise{
+
+    private:
+
+    double mean_; //!< Mean of the Poisson distribution (Vext*h)
+    unsigned int shift_; //!< 64-log2(K) : the index of the case is given by the random number shifted of shift_ bits
+    uint64_t fractionMask_; //!< 2^shift_-1, selects the bits compared with the thresholds
+    std::vector<uint64_t> thresholds_; //!< A draw of the case k returns k if the other bits are lower than thresholds_[k], alias_[k] otherwise
+    std::vector<uint32_t> alias_; //!< The alias of each case
+    Xoshiro256 generator_; //!< The random generator
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Constructor, computes the alias table of the Poisson distribution
+     * @param mean is the mean of the distribution (Vext*h)
+     * @param seed is the seed of the generator
+     * @param stream is the stream of the generator (see Xoshiro256)
+     */
+    BackgroundNoise(double const& mean = 0, uint64_t const& seed = 0, uint64_t const& stream = 0);
+
+    /**
+     * @return mean_
+     */
+    double getMean() const;
+    /**
+     * @return the number of cases of the alias table
+     */
+    size_t getTableSize() const;
+    /**
+     * @return the random generator, to save or restore its state
+     */
+    Xoshiro256& getGenerator();
+    /**
+     * @return the random generator, to save its state
+     */
+    Xoshiro256 const& getGenerator() const;
+
+    /*********************************************************************/
+
+    /**
+     * Draws one number of the Poisson distribution. Defined in the header, so that it is inlined in the loops
+     * @return a number of spikes
+     */
+    unsigned int operator()(){
+
+        uint64_t random(generator_());
+        uint64_t idx(random >> shift_);
+
+        return (random & fractionMask_) < thresholds_[idx] ? idx : alias_[idx];
+    }
+
+    /**
+     * Draws the numbers of spikes of a whole range of neurons at once
+     * @param counts receives the numbers of spikes
+     * @param nb is the number of draws
+     */
+    void fill(unsigned int* counts, size_t const& nb);
+
+};
+
+#endif
@@ -0,0 +1,100 @@
+#include "checkpoint.hpp"
+#include <cassert>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+const char CheckpointWriter::magic[8] = "BRUNCKP";
+const uint32_t CheckpointWriter::version = 6;
+const size_t CheckpointWriter::alignment = 64;
+
+CheckpointWriter::CheckpointWriter(std::string const& fileName)
+: file_(fileName, std::ios::binary | std::ios::trunc), fileName_(fileName), position_(0)
+{
+    if(file_.fail())
+        throw(std::string("Impossible to open the checkpoint file ") + fileName);
+
+    writeBytes(magic, sizeof(magic));
+    write(version);
+}
+
+void CheckpointWriter::writeBytes(const void* data, size_t const& nb){
+
+    file_.write(static_cast<const char*>(data), nb);
+    position_ += nb;
+}
+
+void CheckpointWriter::pad(){
+
+    static const char zeros[64] = {0};
+    assert(alignment <= sizeof(zeros));
+
+    size_t nb((alignment - position_%alignment)%alignment);
+    writeBytes(zeros, nb);
+}
+
+void CheckpointWriter::close(){
+
+    file_.close();
+    if(file_.fail())
+        throw(std::string("Impossible to write the checkpoint file ") + fileName_);
+}
+
+/*********************************************************************/
+
+CheckpointReader::CheckpointReader(std::string const& fileName)
+: data_(nullptr), size_(0), position_(0), fileName_(fileName)
+{
+    int descriptor(open(fileName.c_str(), O_RDONLY));
+    if(descriptor < 0)
+        throw(std::string("Impossible to open the checkpoint file ") + fileName);
+
+    struct stat status;
+    void* address(MAP_FAILED);
+    if(fstat(descriptor, &status) == 0 and status.st_size > 0){
+        size_ = status.st_size;
+        address = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    }
+    //The mapping stays valid after the file is closed
+    ::close(descriptor);
+
+    if(address == MAP_FAILED)
+        throw(std::string("Impossible to map the checkpoint file ") + fileName);
+
+    size_t size(size_);
+    mapping_ = std::shared_ptr<const void>(address, [size](const void* mapped){ munmap(const_cast<void*>(mapped), size); });
+    data_ = static_cast<const char*>(address);
+
+    char fileMagic[sizeof(CheckpointWriter::magic)];
+    uint32_t fileVersion(0);
+    if(size_ < sizeof(fileMagic) + sizeof(fileVersion))
+        fail("is not a checkpoint file");
+    read(fileMagic);
+    read(fileVersion);
+
+    if(std::memcmp(fileMagic, CheckpointWriter::magic, sizeof(fileMagic)) != 0)
+        fail("is not a checkpoint file");
+    if(fileVersion != CheckpointWriter::version)
+        fail("has an unknown version of the checkpoint format");
+}
+
+const char* CheckpointReader::readBytes(size_t const& nb){
+
+    if(position_ > size_ or nb > size_ - position_)
+        fail("is incomplete");
+
+    const char* bytes(data_ + position_);
+    position_ += nb;
+    return bytes;
+}
+
+std::shared_ptr<const void> const& CheckpointReader::getMapping() const{
+
+    return mapping_;
+}
+
+void CheckpointReader::fail(std::string const& message) const{
+
+    throw(fileName_ + " " + message);
+}
@@ -0,0 +1,186 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+//!  Class CheckpointWriter
+/*!
+ This class writes a binary checkpoint file : the magic "BRUNCKP", the version of the format, then values and arrays in the order chosen by the classes that save their state.
+
+ A value is written as its binary representation. An array is written as its number of elements (uint64), then its elements beginning at a multiple of 64 bytes, so that the file can be memory-mapped and the arrays used in place.
+ The values are written in the byte order of the machine : a checkpoint is meant to be restored on the same kind of machine.
+ */
+
+class CheckpointWriter{
+
+    private:
+
+    std::ofstream file_; //!< The checkpoint file
+    std::string fileName_; //!< The name of the file, for the error messages
+    uint64_t position_; //!< Number of bytes written since the beginning of the file
+
+
+    /*********************************************************************/
+
+    /**
+     * Writes bytes in the file
+     * @param data is a pointer on the first byte
+     * @param nb is the number of bytes
+     */
+    void writeBytes(const void* data, size_t const& nb);
+
+    /**
+     * Writes zeros until the position is a multiple of alignment
+     */
+    void pad();
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    static const char magic[8]; //!< First bytes of a checkpoint file
+    static const uint32_t version; //!< Version of the format
+    static const size_t alignment; //!< The arrays begin at a multiple of alignment bytes
+
+    /**
+     * Opens the file and writes the magic and the version
+     * @param fileName is the name of the file
+     * @throw std::string if the file can't be opened
+     */
+    CheckpointWriter(std::string const& fileName);
+
+    /**
+     * Writes one value
+     * @param value is the value
+     */
+    template<typename T>
+    void write(T const& value){
+
+        writeBytes(&value, sizeof(T));
+    }
+
+    /**
+     * Writes an array : its number of elements, then the elements at an aligned position
+     * @param data is a pointer on the first element
+     * @param nb is the number of elements
+     */
+    template<typename T>
+    void writeArray(const T* data, uint64_t const& nb){
+
+        write(nb);
+        pad();
+        writeBytes(data, nb*sizeof(T));
+    }
+
+    /**
+     * Closes the file
+     * @throw std::string if something couldn't be written
+     */
+    void close();
+
+};
+
+
+//!  Class CheckpointReader
+/*!
+ This class reads a checkpoint file written by CheckpointWriter, in the same order. The file is memory-mapped : the arrays can be copied, or used in place as long as the mapping is kept alive (see getMapping).
+ */
+
+class CheckpointReader{
+
+    private:
+
+    std::shared_ptr<const void> mapping_; //!< The memory-mapped file, unmapped when the last owner is destroyed
+    const char* data_; //!< The first byte of the file
+    size_t size_; //!< Size of the file in bytes
+    size_t position_; //!< Position of the next value to read
+    std::string fileName_; //!< The name of the file, for the error messages
+
+
+    /*********************************************************************/
+
+    /**
+     * Reads bytes in the file
+     * @param nb is the number of bytes
+     * @return a pointer on the first byte read
+     * @throw std::string if the file is too short
+     */
+    const char* readBytes(size_t const& nb);
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Maps the file in memory and checks its magic and its version
+     * @param fileName is the name of the file
+     * @throw std::string if the file can't be mapped or is not a checkpoint
+     */
+    CheckpointReader(std::string const& fileName);
+
+    /**
+     * Reads one value
+     * @param value receives the value
+     */
+    template<typename T>
+    void read(T& value){
+
+        std::memcpy(&value, readBytes(sizeof(T)), sizeof(T));
+    }
+
+    /**
+     * Reads an array in place, without copying it
+     * @param nb receives the number of elements
+     * @return a pointer on the first element in the mapped file
+     */
+    template<typename T>
+    const T* readArray(uint64_t& nb){
+
+        read(nb);
+        position_ = (position_ + CheckpointWriter::alignment - 1)/CheckpointWriter::alignment*CheckpointWriter::alignment;
+        //A damaged number of elements could overflow the number of bytes
+        if(position_ > size_ or nb > (size_ - position_)/sizeof(T))
+            fail("is incomplete");
+        return reinterpret_cast<const T*>(readBytes(nb*sizeof(T)));
+    }
+
+    /**
+     * Reads an array and copies it
+     * @param array receives the elements
+     */
+    template<typename T>
+    void readArray(std::vector<T>& array){
+
+        uint64_t nb(0);
+        const T* data(readArray<T>(nb));
+        array.assign(data, data + nb);
+    }
+
+    /**
+     * @return the owner of the mapped file, to keep it alive while arrays are used in place
+     */
+    std::shared_ptr<const void> const& getMapping() const;
+
+    /**
+     * Throws an error about the content of the file
+     * @param message describes the error
+     * @throw std::string always
+     */
+    void fail(std::string const& message) const;
+
+};
+
+#endif
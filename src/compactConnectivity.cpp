@@ -0,0 +1,139 @@
+#include "compactConnectivity.hpp"
+#include <cassert>
+
+namespace {
+
+    //!  Struct CompactStorage
+    /*!
+     The two arrays of a CompactConnectivity built in memory
+     */
+    struct CompactStorage{
+
+        std::vector<size_t> offsets; //!< See CompactConnectivity::offsets_
+        std::vector<uint16_t> deltas; //!< See CompactConnectivity::deltas_
+    };
+}
+
+const uint16_t CompactConnectivity::escape = UINT16_MAX;
+
+CompactConnectivity::CompactConnectivity()
+: CompactConnectivity(Connectivity())
+{}
+
+CompactConnectivity::CompactConnectivity(Connectivity const& connections)
+: nbSources_(connections.size()), nbSynapses_(connections.getNbSynapses())
+{
+    std::shared_ptr<CompactStorage> storage(std::make_shared<CompactStorage>());
+    storage->offsets.resize(nbSources_+1, 0);
+    storage->deltas.reserve(nbSynapses_);
+
+    for(size_t source(0) ; source < nbSources_ ; ++source){
+        uint32_t previous(0);
+        for(auto target : connections[source]){
+            assert(target >= previous);
+            if(target - previous < escape)
+                storage->deltas.push_back(target - previous);
+            else {
+                storage->deltas.push_back(escape);
+                storage->deltas.push_back(target & UINT16_MAX);
+                storage->deltas.push_back(target >> 16);
+            }
+            previous = target;
+        }
+        storage->offsets[source+1] = storage->deltas.size();
+    }
+    storage->deltas.shrink_to_fit();
+
+    offsets_ = storage->offsets.data();
+    deltas_ = storage->deltas.data();
+    storage_ = storage;
+}
+
+CompactConnectivity::CompactConnectivity(std::shared_ptr<const void> storage, const size_t* offsets, const uint16_t* deltas, size_t const& nbSources, size_t const& nbSynapses)
+: storage_(std::move(storage)), offsets_(offsets), deltas_(deltas), nbSources_(nbSources), nbSynapses_(nbSynapses)
+{
+    assert(offsets_[0]==0);
+}
+
+/*********************************************************************/
+
+size_t CompactConnectivity::size() const{
+
+    return nbSources_;
+}
+
+size_t CompactConnectivity::getNbSynapses() const{
+
+    return nbSynapses_;
+}
+
+size_t CompactConnectivity::getMemoryUsage() const{
+
+    return (size()+1)*sizeof(size_t) + offsets_[size()]*sizeof(uint16_t);
+}
+
+CompactConnectivity::TargetReader CompactConnectivity::operator[](size_t source) const{
+
+    assert(source < size());
+    TargetReader reader = {deltas_ + offsets_[source], deltas_ + offsets_[source+1], 0};
+    return reader;
+}
+
+std::vector<uint32_t> CompactConnectivity::getTargets(size_t const& source) const{
+
+    std::vector<uint32_t> targets;
+    for(TargetReader reader((*this)[source]) ; reader.hasNext() ;)
+        targets.push_back(reader.next());
+    return targets;
+}
+
+bool CompactConnectivity::isValid(size_t const& nbTargets) const{
+
+    size_t nbSynapses(0);
+    for(size_t source(0) ; source < size() ; ++source){
+        if(offsets_[source+1] < offsets_[source] or offsets_[source+1] > offsets_[size()])
+            return false;
+        //In 64 bits, so that a damaged difference can't wrap around
+        uint64_t target(0);
+        for(size_t k(offsets_[source]) ; k < offsets_[source+1] ; ++k, ++nbSynapses){
+            if(deltas_[k] != escape)
+                target += deltas_[k];
+            else {
+                //The escape and the two words of the whole target, which can't be lower than the previous one
+                if(offsets_[source+1] - k < 3)
+                    return false;
+                uint64_t whole(static_cast<uint64_t>(deltas_[k+1]) | (static_cast<uint64_t>(deltas_[k+2]) << 16));
+                if(whole < target)
+                    return false;
+                target = whole;
+                k += 2;
+            }
+            if(target >= nbTargets)
+                return false;
+        }
+    }
+    return nbSynapses == nbSynapses_;
+}
+
+/*********************************************************************/
+
+void CompactConnectivity::save(CheckpointWriter& writer) const{
+
+    writer.write<uint64_t>(nbSynapses_);
+    writer.writeArray(offsets_, size()+1);
+    writer.writeArray(deltas_, offsets_[size()]);
+}
+
+CompactConnectivity CompactConnectivity::restore(CheckpointReader& reader){
+
+    uint64_t nbSynapses(0), nbOffsets(0), nbDeltas(0);
+    reader.read(nbSynapses);
+    const size_t* offsets(reader.readArray<size_t>(nbOffsets));
+    const uint16_t* deltas(reader.readArray<uint16_t>(nbDeltas));
+
+    //Each target takes one word, or three with the escape
+    if(nbOffsets == 0 or offsets[0] != 0 or offsets[nbOffsets-1] != nbDeltas or nbSynapses > nbDeltas or 3*nbSynapses < nbDeltas)
+        reader.fail("has inconsistent compact connections");
+
+    return CompactConnectivity(reader.getMapping(), offsets, deltas, nbOffsets-1, nbSynapses);
+}
@@ -0,0 +1,148 @@
+#ifndef COMPACT_CONNECTIVITY_H
+#define COMPACT_CONNECTIVITY_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <cassert>
+#include "connectivity.hpp"
+#include "checkpoint.hpp"
+
+
+//!  Class CompactConnectivity
+/*!
+ This class stores the sorted targets of each source as differences of 16 bits instead of indexes of 32 bits : the targets of the source idx are the prefix sums of deltas_[offsets_[idx]] to deltas_[offsets_[idx+1]-1], beginning at 0.
+ A difference that doesn't fit in 16 bits is written as the escape value 0xFFFF followed by the whole target in two words (low then high), so that any network of less than 2^32 neurons can be encoded. In the networks of Brunel, a source has about a tenth of the neurons as targets : the differences are around 10, the escape never happens and the connections take 2 bytes per synapse instead of 4 (31 MB instead of 62.5 MB at 12500 neurons).
+
+ The targets can only be read in order, from the first one : a thread looking for the targets of its range of neurons decodes all the targets before it. Like Connectivity, a CompactConnectivity is frozen and its copies share the same arrays.
+ */
+
+class CompactConnectivity{
+
+    public:
+
+    static const uint16_t escape; //!< Difference that announces a whole target in the two next words
+
+    //!  Struct TargetReader
+    /*!
+     Reads the targets of one source in increasing order
+     */
+    struct TargetReader{
+
+        const uint16_t* position_; //!< Next word to read
+        const uint16_t* end_; //!< After the last word of the source
+        uint32_t target_; //!< Last target read, 0 before the first one
+
+        /**
+         * @return true if there is still a target to read
+         */
+        bool hasNext() const { return position_ != end_; }
+
+        /**
+         * Reads the next target, hasNext() has to be true
+         * @return the index of the neuron that is the next target
+         */
+        inline uint32_t next(){
+
+            uint16_t delta(*position_++);
+            if(delta != escape)
+                target_ += delta;
+            else {
+                //The whole target is in the two next words of the source
+                assert(end_ - position_ >= 2);
+                target_ = static_cast<uint32_t>(position_[0]) | (static_cast<uint32_t>(position_[1]) << 16);
+                position_ += 2;
+            }
+            return target_;
+        }
+    };
+
+    private:
+
+    std::shared_ptr<const void> storage_; //!< Owns the memory of the two arrays, shared by all the copies
+    const size_t* offsets_; //!< offsets_[idx] is the position of the first word of idx in deltas_. Has a length of size()+1
+    const uint16_t* deltas_; //!< The words of all the sources, one after the other
+    size_t nbSources_; //!< Number of sources
+    size_t nbSynapses_; //!< Number of targets of all the sources (lower than the number of words if there are escapes)
+
+    /**
+     * Constructor on two arrays that are owned by storage
+     * @param storage keeps the memory of the arrays alive as long as a copy of the connections exists
+     * @param offsets has a length of nbSources + 1
+     * @param deltas has a length of offsets[nbSources]
+     * @param nbSources is the number of sources
+     * @param nbSynapses is the number of targets encoded in deltas
+     */
+    CompactConnectivity(std::shared_ptr<const void> storage, const size_t* offsets, const uint16_t* deltas, size_t const& nbSources, size_t const& nbSynapses);
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Constructor of empty connections, without any source
+     */
+    CompactConnectivity();
+
+    /**
+     * Constructor of the encoding of stored connections
+     * @param connections are the connections, the targets of each source have to be sorted by increasing index
+     */
+    explicit CompactConnectivity(Connectivity const& connections);
+
+
+    /*********************************************************************/
+
+    /**
+     * @return the number of sources
+     */
+    size_t size() const;
+    /**
+     * @return the total number of connections
+     */
+    size_t getNbSynapses() const;
+    /**
+     * @return the number of bytes used by the two arrays
+     */
+    size_t getMemoryUsage() const;
+
+    /**
+     * @param source is the index of the source
+     * @return a reader on the targets of source
+     */
+    TargetReader operator[](size_t source) const;
+    /**
+     * @param source is the index of the source
+     * @return the targets of source, decoded
+     */
+    std::vector<uint32_t> getTargets(size_t const& source) const;
+    /**
+     * Decodes all the targets once, for the connections read from a file that may be damaged : the offsets never decrease, no escape is cut by the end of its source, the targets of each source are sorted and lower than nbTargets, and there are getNbSynapses() of them
+     * @param nbTargets is the number of neurons that can be a target
+     * @return true if the targets can be read without reading out of the arrays
+     */
+    bool isValid(size_t const& nbTargets) const;
+
+
+    /*********************************************************************/
+
+    /**
+     * Writes the number of synapses and the two arrays in a checkpoint
+     * @param writer is the checkpoint
+     */
+    void save(CheckpointWriter& writer) const;
+    /**
+     * Reads compact connections from a checkpoint. The arrays are not copied, the connections use the memory-mapped file
+     * @param reader is the checkpoint
+     * @return the connections
+     * @throw std::string if the sizes of the arrays are not consistent (their content is checked by isValid)
+     */
+    static CompactConnectivity restore(CheckpointReader& reader);
+
+};
+
+#endif
@@ -0,0 +1,194 @@
+#include "connectivity.hpp"
+#include <thread>
+
+namespace {
+
+    //!  Struct Storage
+    /*!
+     The two arrays of a Connectivity built in memory
+     */
+    struct Storage{
+
+        std::vector<size_t> offsets; //!< See Connectivity::offsets_
+        std::vector<uint32_t> targets; //!< See Connectivity::targets_
+    };
+
+    /**
+     * @param adjacency : adjacency[idx] contains the targets of idx
+     * @return the offsets of the CSR format of adjacency
+     */
+    std::vector<size_t> adjacencyOffsets(std::vector< std::vector<size_t> > const& adjacency){
+
+        std::vector<size_t> offsets(adjacency.size()+1, 0);
+        for(size_t source(0) ; source < adjacency.size() ; ++source)
+            offsets[source+1] = offsets[source] + adjacency[source].size();
+        return offsets;
+    }
+
+    /**
+     * @param adjacency : adjacency[idx] contains the targets of idx
+     * @return the targets of the CSR format of adjacency
+     */
+    std::vector<uint32_t> adjacencyTargets(std::vector< std::vector<size_t> > const& adjacency){
+
+        std::vector<uint32_t> targets;
+        for(auto const& list : adjacency){
+            for(auto target : list)
+                targets.push_back(target);
+        }
+        return targets;
+    }
+}
+
+Connectivity::Connectivity()
+: Connectivity(std::vector<size_t>(1, 0), std::vector<uint32_t>())
+{}
+
+Connectivity::Connectivity(std::vector<size_t> offsets, std::vector<uint32_t> targets)
+{
+    assert(!offsets.empty());
+    assert(offsets.front()==0);
+    assert(offsets.back()==targets.size());
+
+    //The arrays are moved into a storage shared by the copies, they don't move anymore
+    std::shared_ptr<Storage> storage(std::make_shared<Storage>());
+    storage->offsets = std::move(offsets);
+    storage->targets = std::move(targets);
+
+    offsets_ = storage->offsets.data();
+    targets_ = storage->targets.data();
+    nbSources_ = storage->offsets.size()-1;
+    storage_ = storage;
+}
+
+Connectivity::Connectivity(std::vector< std::vector<size_t> > const& adjacency)
+: Connectivity(adjacencyOffsets(adjacency), adjacencyTargets(adjacency))
+{}
+
+Connectivity::Connectivity(std::shared_ptr<const void> storage, const size_t* offsets, const uint32_t* targets, size_t const& nbSources)
+: storage_(std::move(storage)), offsets_(offsets), targets_(targets), nbSources_(nbSources)
+{
+    assert(offsets_[0]==0);
+}
+
+/*********************************************************************/
+
+size_t Connectivity::size() const{
+
+    return nbSources_;
+}
+
+size_t Connectivity::getNbSynapses() const{
+
+    return offsets_[nbSources_];
+}
+
+size_t Connectivity::getMemoryUsage() const{
+
+    return (size()+1)*sizeof(size_t) + getNbSynapses()*sizeof(uint32_t);
+}
+
+bool Connectivity::isValid(size_t const& nbTargets) const{
+
+    for(size_t source(0) ; source < size() ; ++source){
+        if(offsets_[source+1] < offsets_[source] or offsets_[source+1] > getNbSynapses())
+            return false;
+        for(size_t k(offsets_[source]) ; k < offsets_[source+1] ; ++k){
+            if(targets_[k] >= nbTargets or (k > offsets_[source] and targets_[k] < targets_[k-1]))
+                return false;
+        }
+    }
+    return true;
+}
+
+Connectivity::TargetRange Connectivity::operator[](size_t source) const{
+
+    assert(source < size());
+    TargetRange range = {targets_ + offsets_[source], targets_ + offsets_[source+1]};
+    return range;
+}
+
+/*********************************************************************/
+
+Connectivity Connectivity::transpose(size_t const& nbTargets, unsigned int const& nbThreads) const{
+
+    assert(nbThreads > 0);
+
+    //Each thread handles a range of sources, the sources of the thread t are firstSource[t] to firstSource[t+1]-1
+    std::vector<size_t> firstSource(nbThreads+1);
+    for(unsigned int t(0) ; t <= nbThreads ; ++t)
+        firstSource[t] = size()*t/nbThreads;
+
+    //Counts the number of sources of each target, in each range of sources
+    std::vector< std::vector<size_t> > counts(nbThreads);
+    auto count = [&](unsigned int const& t){
+        counts[t].assign(nbTargets, 0);
+        for(size_t k(offsets_[firstSource[t]]) ; k < offsets_[firstSource[t+1]] ; ++k){
+            assert(targets_[k] < nbTargets);
+            ++counts[t][targets_[k]];
+        }
+    };
+
+    //The prefix sum of the counts gives the beginning of each list, and the position of the first connection of each range of sources in this list
+    std::vector<size_t> offsets(nbTargets+1, 0);
+    auto prefixSum = [&](){
+        for(size_t i(0) ; i < nbTargets ; ++i){
+            size_t position(offsets[i]);
+            for(unsigned int t(0) ; t < nbThreads ; ++t){
+                size_t nb(counts[t][i]);
+                counts[t][i] = position;
+                position += nb;
+            }
+            offsets[i+1] = position;
+        }
+    };
+
+    //Places each connection in the list of its target. The ranges of sources are in increasing order, and the sources of each range are visited in increasing order, so that each list is sorted
+    std::vector<uint32_t> targets(getNbSynapses());
+    auto place = [&](unsigned int const& t){
+        std::vector<size_t>& position(counts[t]);
+        for(size_t source(firstSource[t]) ; source < firstSource[t+1] ; ++source){
+            for(size_t k(offsets_[source]) ; k < offsets_[source+1] ; ++k)
+                targets[position[targets_[k]]++] = source;
+        }
+    };
+
+    //The thread 0 is the calling thread
+    std::vector<std::thread> threads;
+    for(unsigned int t(1) ; t < nbThreads ; ++t)
+        threads.push_back(std::thread(count, t));
+    count(0);
+    for(auto& thread : threads)
+        thread.join();
+
+    prefixSum();
+
+    threads.clear();
+    for(unsigned int t(1) ; t < nbThreads ; ++t)
+        threads.push_back(std::thread(place, t));
+    place(0);
+    for(auto& thread : threads)
+        thread.join();
+
+    return Connectivity(std::move(offsets), std::move(targets));
+}
+
+/*********************************************************************/
+
+void Connectivity::save(CheckpointWriter& writer) const{
+
+    writer.writeArray(offsets_, size()+1);
+    writer.writeArray(targets_, getNbSynapses());
+}
+
+Connectivity Connectivity::restore(CheckpointReader& reader){
+
+    uint64_t nbOffsets(0), nbTargets(0);
+    const size_t* offsets(reader.readArray<size_t>(nbOffsets));
+    const uint32_t* targets(reader.readArray<uint32_t>(nbTargets));
+
+    if(nbOffsets == 0 or offsets[0] != 0 or offsets[nbOffsets-1] != nbTargets)
+        reader.fail("has inconsistent connections");
+
+    return Connectivity(reader.getMapping(), offsets, targets, nbOffsets-1);
+}
@@ -0,0 +1,150 @@
+#ifndef CONNECTIVITY_H
+#define CONNECTIVITY_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <utility>
+#include <memory>
+#include "checkpoint.hpp"
+
+
+//!  Class Connectivity
+/*!
+ This class stores the connections of a network in a frozen compressed sparse row (CSR) format : one array of offsets and one array of 32 bits targets.
+ The targets of the source idx are targets_[offsets_[idx]] to targets_[offsets_[idx+1]-1], so that iterating on the targets of a neuron is a contiguous scan of memory.
+
+ A Connectivity can't be modified once it is built. The network generates the list of the sources of each neuron, and transposes it to obtain the list of the targets of each neuron.
+ Since it is frozen, the copies of a Connectivity share the same arrays : a network of 12.5M synapses can be given to many networks (a parameter sweep for example) without copying it.
+ */
+
+class Connectivity{
+
+    public:
+
+    //!  Struct TargetRange
+    /*!
+     View on the targets of one source, that can be used like a vector (size, [] and range-based for loops)
+     */
+    struct TargetRange{
+
+        const uint32_t* begin_; //!< First target of the source
+        const uint32_t* end_; //!< After the last target of the source
+
+        /**
+         * @return a pointer on the first target
+         */
+        const uint32_t* begin() const { return begin_; }
+        /**
+         * @return a pointer after the last target
+         */
+        const uint32_t* end() const { return end_; }
+        /**
+         * @return the number of targets
+         */
+        size_t size() const { return end_ - begin_; }
+        /**
+         * @param i is the index of the target in the list
+         * @return the index of the neuron that is the i-th target
+         */
+        uint32_t operator[](size_t i) const { return begin_[i]; }
+    };
+
+    private:
+
+    std::shared_ptr<const void> storage_; //!< Owns the memory of the two arrays, shared by all the copies
+    const size_t* offsets_; //!< offsets_[idx] is the position of the first target of idx in targets_. Has a length of size()+1
+    const uint32_t* targets_; //!< The targets of all the sources, one after the other
+    size_t nbSources_; //!< Number of sources
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Constructor of an empty connectivity
+     */
+    Connectivity();
+
+    /**
+     * Constructor from the two arrays of the CSR format
+     * @param offsets has a length of the number of sources + 1, offsets[0]=0 and offsets.back()=targets.size()
+     * @param targets contains the targets of all the sources, one after the other
+     */
+    Connectivity(std::vector<size_t> offsets, std::vector<uint32_t> targets);
+
+    /**
+     * Constructor from a vector containing the targets of each source (used in the tests)
+     * @param adjacency : adjacency[idx] contains the targets of idx
+     */
+    Connectivity(std::vector< std::vector<size_t> > const& adjacency);
+
+    /**
+     * Constructor on two arrays that are not owned by the connectivity (a memory-mapped file for example)
+     * @param storage keeps the memory of the arrays alive as long as a copy of the connectivity exists
+     * @param offsets has a length of nbSources + 1
+     * @param targets has a length of offsets[nbSources]
+     * @param nbSources is the number of sources
+     */
+    Connectivity(std::shared_ptr<const void> storage, const size_t* offsets, const uint32_t* targets, size_t const& nbSources);
+
+
+    /*********************************************************************/
+
+    /**
+     * @return the number of sources
+     */
+    size_t size() const;
+    /**
+     * @return the total number of connections
+     */
+    size_t getNbSynapses() const;
+    /**
+     * @return the number of bytes used by the two arrays
+     */
+    size_t getMemoryUsage() const;
+    /**
+     * Checks the arrays in one pass, for the connections read from a file that may be damaged : the offsets never decrease, and the targets of each source are sorted and lower than nbTargets
+     * @param nbTargets is the number of neurons that can be a target
+     * @return true if the connections can be used without reading out of the buffers
+     */
+    bool isValid(size_t const& nbTargets) const;
+
+    /**
+     * @param source is the index of the source
+     * @return the targets of source
+     */
+    TargetRange operator[](size_t source) const;
+
+
+    /*********************************************************************/
+
+    /**
+     * Reverses all the connections, with a counting sort : if b is a target of a in this*, a is a target of b in the result. The targets of each source of the result are sorted by increasing index.
+     * With several threads, each thread counts then places the connections of a range of sources, at positions given by the counts of the threads before it : the result doesn't depend on the number of threads
+     * @param nbTargets is the number of neurons that can be a target (the number of sources of the result)
+     * @param nbThreads is the number of threads of the sort (1 by default)
+     * @return the transposed connectivity
+     */
+    Connectivity transpose(size_t const& nbTargets, unsigned int const& nbThreads = 1) const;
+
+    /**
+     * Writes the two arrays in a checkpoint
+     * @param writer is the checkpoint
+     */
+    void save(CheckpointWriter& writer) const;
+    /**
+     * Reads a connectivity from a checkpoint. The arrays are not copied, the connectivity uses the memory-mapped file
+     * @param reader is the checkpoint
+     * @return the connectivity
+     * @throw std::string if the arrays are not consistent
+     */
+    static Connectivity restore(CheckpointReader& reader);
+
+};
+
+#endif
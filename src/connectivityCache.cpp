@@ -0,0 +1,100 @@
+#include "connectivityCache.hpp"
+#include <cstdio>
+#include <chrono>
+#include <sstream>
+
+const uint32_t ConnectivityCache::generatorVersion = 1;
+
+ConnectivityCache::ConnectivityCache(std::string const& directory)
+: directory_(directory), loaded_(false), loadTime_(0)
+{}
+
+/*********************************************************************/
+
+std::string ConnectivityCache::getFileName(ConnectivityGenerator const& generator) const{
+
+    std::ostringstream name;
+    name << directory_ << "/connectivity_E" << generator.getNbExcitatory() << "_I" << generator.getNbInhibitory() << "_eps" << generator.getEpsilon() << "_seed" << generator.getSeed() << ".bin";
+    return name.str();
+}
+
+bool ConnectivityCache::wasLoaded() const{
+
+    return loaded_;
+}
+
+double ConnectivityCache::getLoadTime() const{
+
+    return loadTime_;
+}
+
+/*********************************************************************/
+
+bool ConnectivityCache::load(ConnectivityGenerator const& generator, Connectivity& connections) const{
+
+    try{
+        CheckpointReader reader(getFileName(generator));
+
+        //The key is checked exactly : the name of the file only contains a rounded epsilon
+        uint32_t version(0);
+        uint64_t nbExcitatory(0), nbInhibitory(0), seed(0);
+        double epsilon(0);
+        reader.read(version);
+        reader.read(nbExcitatory);
+        reader.read(nbInhibitory);
+        reader.read(epsilon);
+        reader.read(seed);
+        if(version != generatorVersion or nbExcitatory != generator.getNbExcitatory() or nbInhibitory != generator.getNbInhibitory() or epsilon != generator.getEpsilon() or seed != generator.getSeed())
+            return false;
+
+        //The arrays are used in place : a damaged offset or target would make the spikes be written out of the buffers
+        connections = Connectivity::restore(reader);
+        return connections.size() == nbExcitatory + nbInhibitory and connections.isValid(nbExcitatory + nbInhibitory);
+    }
+    catch(std::string const&){
+        //Missing or damaged file : the connections are generated again
+        return false;
+    }
+}
+
+void ConnectivityCache::save(ConnectivityGenerator const& generator, Connectivity const& connections) const{
+
+    std::string fileName(getFileName(generator));
+    std::string temporaryName(fileName + ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+
+    try{
+        CheckpointWriter writer(temporaryName);
+        writer.write(generatorVersion);
+        writer.write<uint64_t>(generator.getNbExcitatory());
+        writer.write<uint64_t>(generator.getNbInhibitory());
+        writer.write(generator.getEpsilon());
+        writer.write<uint64_t>(generator.getSeed());
+        connections.save(writer);
+        writer.close();
+    }
+    catch(std::string const&){
+        std::remove(temporaryName.c_str());
+        return;
+    }
+
+    //The complete file replaces the old one at once
+    if(std::rename(temporaryName.c_str(), fileName.c_str()) != 0)
+        std::remove(temporaryName.c_str());
+}
+
+Connectivity ConnectivityCache::get(ConnectivityGenerator& generator){
+
+    std::chrono::steady_clock::time_point begin(std::chrono::steady_clock::now());
+
+    Connectivity connections;
+    loaded_ = load(generator, connections);
+    if(loaded_){
+        loadTime_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        return connections;
+    }
+
+    loadTime_ = 0;
+    connections = generator.generate();
+    save(generator, connections);
+    return connections;
+}
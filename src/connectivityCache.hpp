@@ -0,0 +1,84 @@
+#ifndef CONNECTIVITY_CACHE_H
+#define CONNECTIVITY_CACHE_H
+
+#include <string>
+#include <cstdint>
+#include "connectivity.hpp"
+#include "connectivityGenerator.hpp"
+
+
+//!  Class ConnectivityCache
+/*!
+ This class keeps the connections generated by a ConnectivityGenerator in a directory, so that the runs with the same graph don't generate it again.
+
+ A graph only depends on the numbers of excitatory and inhibitory neurons, on epsilon and on the seed of the connections : each key has its own file, written with CheckpointWriter (the key, the version of the generator, then the arrays of the Connectivity).
+ A file found in the cache is memory-mapped and used in place, without copying the 12.5M synapses. A file that doesn't have the right key or can't be read is replaced by a new generation.
+ The file is written under a temporary name and renamed once complete, so that a run never reads a file that another run is writing.
+ */
+
+class ConnectivityCache{
+
+    private:
+
+    std::string directory_; //!< The directory of the files of the cache
+    bool loaded_; //!< True if the last connections were read from the cache
+    double loadTime_; //!< Duration of the last reading of the cache in [s], 0 if the connections were generated
+
+
+    /*********************************************************************/
+
+    /**
+     * Reads the connections of a key from its file
+     * @param generator contains the key (numbers of neurons, epsilon and seed)
+     * @param connections receives the connections
+     * @return false if the file doesn't exist, has another key or is not valid
+     */
+    bool load(ConnectivityGenerator const& generator, Connectivity& connections) const;
+
+    /**
+     * Writes the connections of a key in its file. The cache is only an optimisation : an error is ignored
+     * @param generator contains the key (numbers of neurons, epsilon and seed)
+     * @param connections are the connections generated with this key
+     */
+    void save(ConnectivityGenerator const& generator, Connectivity const& connections) const;
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    static const uint32_t generatorVersion; //!< Version of the algorithm of ConnectivityGenerator, a file of another version is generated again
+
+    /**
+     * Constructor of a cache
+     * @param directory is the directory of the files, which has to exist
+     */
+    ConnectivityCache(std::string const& directory);
+
+    /**
+     * @param generator contains the key (numbers of neurons, epsilon and seed)
+     * @return the name of the file of the connections of this key
+     */
+    std::string getFileName(ConnectivityGenerator const& generator) const;
+
+    /**
+     * Reads the connections of the key of a generator from the cache, or generates them and adds them to the cache
+     * @param generator generates the connections if they are not in the cache
+     * @return the connections
+     */
+    Connectivity get(ConnectivityGenerator& generator);
+
+    /**
+     * @return loaded_
+     */
+    bool wasLoaded() const;
+    /**
+     * @return loadTime_
+     */
+    double getLoadTime() const;
+
+};
+
+#endif
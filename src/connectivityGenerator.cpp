@@ -0,0 +1,171 @@
+#include "connectivityGenerator.hpp"
+#include "xoshiro256.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+const size_t ConnectivityGenerator::blockSize = 1024;
+
+namespace {
+
+    __extension__ typedef unsigned __int128 uint128; //!< Product of two 64 bits words
+
+    /**
+     * Draws a number uniformly from a range, with the high word of the product of 64 random bits and the size of the range (no division, the bias is smaller than size/2^64)
+     * @param generator is the random generator
+     * @param first is the smallest number of the range
+     * @param size is the number of values of the range
+     * @return a number from first to first+size-1
+     */
+    inline uint32_t drawInRange(Xoshiro256& generator, uint32_t const& first, uint64_t const& size){
+
+        return first + static_cast<uint32_t>((static_cast<uint128>(generator()) * size) >> 64);
+    }
+
+    /**
+     * @param begin is the beginning of an interval of time
+     * @return the number of seconds since begin
+     */
+    double secondsSince(std::chrono::steady_clock::time_point const& begin){
+
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+}
+
+ConnectivityGenerator::ConnectivityGenerator(unsigned long int const& nbExcitatory, unsigned long int const& nbInhibitory, double const& epsilon, uint64_t const& seed)
+: nbExcitatory_(nbExcitatory), nbInhibitory_(nbInhibitory), epsilon_(epsilon), seed_(seed), nbThreads_(std::max(1u, std::thread::hardware_concurrency())), timings_()
+{
+    assert(nbExcitatory_ > 0);
+    assert(nbInhibitory_ > 0);
+    assert(nbExcitatory_ + nbInhibitory_ <= UINT32_MAX);
+}
+
+/*********************************************************************/
+
+void ConnectivityGenerator::setNbThreads(unsigned int const& nb){
+
+    assert(nb > 0);
+    nbThreads_ = nb;
+}
+
+unsigned int ConnectivityGenerator::getNbThreads() const{
+
+    return nbThreads_;
+}
+
+unsigned long int ConnectivityGenerator::getNbExcitatory() const{
+
+    return nbExcitatory_;
+}
+
+unsigned long int ConnectivityGenerator::getNbInhibitory() const{
+
+    return nbInhibitory_;
+}
+
+double ConnectivityGenerator::getEpsilon() const{
+
+    return epsilon_;
+}
+
+uint64_t ConnectivityGenerator::getSeed() const{
+
+    return seed_;
+}
+
+size_t ConnectivityGenerator::getNbExcitatorySources() const{
+
+    return std::ceil(epsilon_*nbExcitatory_);
+}
+
+size_t ConnectivityGenerator::getNbInhibitorySources() const{
+
+    return std::ceil(epsilon_*nbInhibitory_);
+}
+
+ConnectivityTimings const& ConnectivityGenerator::getTimings() const{
+
+    return timings_;
+}
+
+/*********************************************************************/
+
+void ConnectivityGenerator::drawBlocks(size_t const& firstBlock, size_t const& lastBlock, size_t const& firstNeuron, size_t const& lastNeuron, uint32_t* sources) const{
+
+    const size_t nbExcitatorySources(getNbExcitatorySources());
+    const size_t nbInhibitorySources(getNbInhibitorySources());
+
+    //The generator of the block b is the generator of the seed jumped b times : the first block is reached once, then each block jumps once from the previous one
+    Xoshiro256 blockGenerator(seed_, firstBlock);
+
+    for(size_t block(firstBlock) ; block < lastBlock ; ++block){
+        Xoshiro256 generator(blockGenerator);
+        blockGenerator.jump();
+
+        size_t last(std::min(lastNeuron, (block+1)*blockSize));
+        size_t idxNeuron(block*blockSize);
+
+        //The neurons of the block before firstNeuron are drawn but not kept, so that the next ones get the same sources
+        for(; idxNeuron < firstNeuron ; ++idxNeuron){
+            for(size_t j(0) ; j < nbExcitatorySources + nbInhibitorySources ; ++j)
+                generator();
+        }
+
+        uint32_t* source(sources + (idxNeuron - firstNeuron)*(nbExcitatorySources + nbInhibitorySources));
+        for(; idxNeuron < last ; ++idxNeuron){
+            //Randomly chooses the excitatory neurons that will have idxNeuron in their targets
+            for(size_t j(0) ; j < nbExcitatorySources ; ++j)
+                *source++ = drawInRange(generator, 0, nbExcitatory_);
+            //Randomly chooses the inhibitory neurons that will have idxNeuron in their targets
+            for(size_t j(0) ; j < nbInhibitorySources ; ++j)
+                *source++ = drawInRange(generator, nbExcitatory_, nbInhibitory_);
+        }
+    }
+}
+
+Connectivity ConnectivityGenerator::generate(){
+
+    return generate(0, nbExcitatory_ + nbInhibitory_);
+}
+
+Connectivity ConnectivityGenerator::generate(size_t const& firstNeuron, size_t const& lastNeuron){
+
+    const size_t nbNeurons(nbExcitatory_ + nbInhibitory_);
+    assert(firstNeuron < lastNeuron and lastNeuron <= nbNeurons);
+    const size_t nbSources(getNbExcitatorySources() + getNbInhibitorySources());
+    const size_t firstBlock(firstNeuron/blockSize);
+    const size_t nbBlocks((lastNeuron + blockSize - 1)/blockSize - firstBlock);
+    const unsigned int nbThreads(std::min<size_t>(nbThreads_, nbBlocks));
+
+    std::chrono::steady_clock::time_point begin(std::chrono::steady_clock::now());
+
+    //Every neuron of the range has nbSources sources, the other ones have none : the sources of idxNeuron begin at (idxNeuron-firstNeuron)*nbSources
+    std::vector<size_t> sourcesOffsets(nbNeurons+1);
+    for(size_t idxNeuron(0) ; idxNeuron <= nbNeurons ; ++idxNeuron)
+        sourcesOffsets[idxNeuron] = (std::min(std::max(idxNeuron, firstNeuron), lastNeuron) - firstNeuron)*nbSources;
+    std::vector<uint32_t> sources((lastNeuron - firstNeuron)*nbSources);
+
+    //Each thread draws a range of blocks, the thread 0 is the calling thread
+    std::vector<std::thread> threads;
+    for(unsigned int t(1) ; t < nbThreads ; ++t)
+        threads.push_back(std::thread(&ConnectivityGenerator::drawBlocks, this, firstBlock + nbBlocks*t/nbThreads, firstBlock + nbBlocks*(t+1)/nbThreads, firstNeuron, lastNeuron, sources.data()));
+    drawBlocks(firstBlock, firstBlock + nbBlocks/nbThreads, firstNeuron, lastNeuron, sources.data());
+    for(auto& thread : threads)
+        thread.join();
+
+    timings_.drawTime = secondsSince(begin);
+    begin = std::chrono::steady_clock::now();
+
+    //The lists of sources are transposed into the frozen lists of targets
+    Connectivity targets(Connectivity(std::move(sourcesOffsets), std::move(sources)).transpose(nbNeurons, nbThreads));
+
+    timings_.sortTime = secondsSince(begin);
+    timings_.nbThreads = nbThreads;
+    timings_.loaded = false;
+    timings_.loadTime = 0;
+
+    return targets;
+}
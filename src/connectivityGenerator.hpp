@@ -0,0 +1,129 @@
+#ifndef CONNECTIVITY_GENERATOR_H
+#define CONNECTIVITY_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include "connectivity.hpp"
+
+
+//!  Struct ConnectivityTimings
+/*!
+ Durations of the steps of the generation of the connections, to know what the building of a network costs
+ */
+struct ConnectivityTimings{
+
+    double drawTime; //!< Time spent drawing the sources of each neuron, in [s]
+    double sortTime; //!< Time spent transposing the sources into the targets of each neuron, in [s]
+    unsigned int nbThreads; //!< Number of threads used
+    bool loaded; //!< True if the connections were read from a ConnectivityCache instead of being generated
+    double loadTime; //!< Time spent reading the connections from the cache, in [s]
+};
+
+
+//!  Class ConnectivityGenerator
+/*!
+ This class generates the random connections of the network of Brunel : each neuron receives ceil(epsilon*nbExcitatory) connections from excitatory neurons and ceil(epsilon*nbInhibitory) connections from inhibitory neurons, chosen uniformly (with repetitions).
+
+ The neurons are cut into blocks of blockSize neurons. The sources of the block b are drawn with the xoshiro256** generator of the seed, jumped to the stream b : the blocks can be drawn by any number of threads, in any order, and a seed always gives the same connections.
+ Since every neuron receives the same number of connections, the sources of all the neurons are written directly in one array. This array is then transposed by a parallel counting sort (see Connectivity::transpose) into the frozen lists of targets used by the simulation.
+ */
+
+class ConnectivityGenerator{
+
+    private:
+
+    unsigned long int nbExcitatory_; //!< Number of excitatory neurons, the first ones
+    unsigned long int nbInhibitory_; //!< Number of inhibitory neurons, after the excitatory ones
+    double epsilon_; //!< Connection probability
+    uint64_t seed_; //!< Seed of the connections
+    unsigned int nbThreads_; //!< Number of threads of the generation. Equals the number of cores at the construction
+    ConnectivityTimings timings_; //!< Durations of the last generation
+
+
+    /*********************************************************************/
+
+    /**
+     * Draws the sources of the neurons of a range of blocks, only the ones from firstNeuron to lastNeuron-1 are kept
+     * @param firstBlock is the index of the first block
+     * @param lastBlock is the index after the last block
+     * @param firstNeuron is the index of the first neuron whose sources are kept
+     * @param lastNeuron is the index after the last neuron whose sources are kept
+     * @param sources is the array of the sources of the neurons kept, the sources of idx begin at (idx-firstNeuron)*(getNbExcitatorySources()+getNbInhibitorySources())
+     */
+    void drawBlocks(size_t const& firstBlock, size_t const& lastBlock, size_t const& firstNeuron, size_t const& lastNeuron, uint32_t* sources) const;
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    static const size_t blockSize; //!< Number of neurons drawn with the same stream of the generator
+
+    /**
+     * Constructor of a generator
+     * @param nbExcitatory is the number of excitatory neurons
+     * @param nbInhibitory is the number of inhibitory neurons
+     * @param epsilon is the connection probability
+     * @param seed is the seed of the connections
+     */
+    ConnectivityGenerator(unsigned long int const& nbExcitatory, unsigned long int const& nbInhibitory, double const& epsilon, uint64_t const& seed);
+
+    /**
+     * Setter of nbThreads_, the connections don't depend on it
+     * @param nb is the number of threads
+     */
+    void setNbThreads(unsigned int const& nb);
+    /**
+     * @return nbThreads_
+     */
+    unsigned int getNbThreads() const;
+    /**
+     * @return nbExcitatory_
+     */
+    unsigned long int getNbExcitatory() const;
+    /**
+     * @return nbInhibitory_
+     */
+    unsigned long int getNbInhibitory() const;
+    /**
+     * @return epsilon_
+     */
+    double getEpsilon() const;
+    /**
+     * @return seed_
+     */
+    uint64_t getSeed() const;
+    /**
+     * @return the number of excitatory sources of each neuron
+     */
+    size_t getNbExcitatorySources() const;
+    /**
+     * @return the number of inhibitory sources of each neuron
+     */
+    size_t getNbInhibitorySources() const;
+
+    /*********************************************************************/
+
+    /**
+     * Generates the connections
+     * @return the targets of each neuron, sorted by increasing index
+     */
+    Connectivity generate();
+    /**
+     * Generates only the connections that reach the neurons firstNeuron to lastNeuron-1, the ones a process of a distributed simulation needs (see SpikeExchange) : they are the same as in the whole network, since the sources of each neuron only depend on its block
+     * @param firstNeuron is the index of the first target
+     * @param lastNeuron is the index after the last target
+     * @return the targets of each neuron of the network that are in the range, sorted by increasing index
+     */
+    Connectivity generate(size_t const& firstNeuron, size_t const& lastNeuron);
+
+    /**
+     * @return the durations of the last generation
+     */
+    ConnectivityTimings const& getTimings() const;
+
+};
+
+#endif
@@ -0,0 +1,79 @@
+#include "delayRingBuffer.hpp"
+#include <cassert>
+#include <cstring>
+
+template<typename Value>
+BasicDelayRingBuffer<Value>::BasicDelayRingBuffer()
+: nbNeurons_(0), nbSlots_(0)
+{}
+
+template<typename Value>
+void BasicDelayRingBuffer<Value>::resize(size_t const& nbNeurons, size_t const& maxDelayInSteps){
+
+    assert(maxDelayInSteps > 0);
+    nbNeurons_ = nbNeurons;
+    nbSlots_ = maxDelayInSteps + 1;
+    buffer_.assign(nbSlots_*nbNeurons_, 0);
+}
+
+template<typename Value>
+size_t BasicDelayRingBuffer<Value>::getNbNeurons() const{
+
+    return nbNeurons_;
+}
+
+template<typename Value>
+size_t BasicDelayRingBuffer<Value>::getNbSlots() const{
+
+    return nbSlots_;
+}
+
+/*********************************************************************/
+
+template<typename Value>
+Value* BasicDelayRingBuffer<Value>::getSlot(size_t const& slot){
+
+    assert(slot < nbSlots_);
+    return buffer_.data() + slot*nbNeurons_;
+}
+
+template<typename Value>
+const Value* BasicDelayRingBuffer<Value>::getSlot(size_t const& slot) const{
+
+    assert(slot < nbSlots_);
+    return buffer_.data() + slot*nbNeurons_;
+}
+
+template<typename Value>
+void BasicDelayRingBuffer<Value>::save(CheckpointWriter& writer) const{
+
+    writer.write<uint64_t>(nbNeurons_);
+    writer.write<uint64_t>(nbSlots_);
+    writer.writeArray(buffer_.data(), buffer_.size());
+}
+
+template<typename Value>
+void BasicDelayRingBuffer<Value>::restore(CheckpointReader& reader){
+
+    uint64_t nbNeurons(0), nbSlots(0);
+    reader.read(nbNeurons);
+    reader.read(nbSlots);
+    reader.readArray(buffer_);
+
+    if(buffer_.size() != nbNeurons*nbSlots)
+        reader.fail("has a delay buffer of the wrong size");
+    nbNeurons_ = nbNeurons;
+    nbSlots_ = nbSlots;
+}
+
+template<typename Value>
+void BasicDelayRingBuffer<Value>::clear(size_t const& slot, size_t const& first, size_t const& last){
+
+    assert(first <= last and last <= nbNeurons_);
+    std::memset(getSlot(slot) + first, 0, (last - first)*sizeof(Value));
+}
+
+//The buffers of the precisions of PrecisionPolicy, and the spike counters
+template class BasicDelayRingBuffer<double>;
+template class BasicDelayRingBuffer<float>;
+template class BasicDelayRingBuffer<uint16_t>;
@@ -0,0 +1,93 @@
+#ifndef DELAY_RING_BUFFER_H
+#define DELAY_RING_BUFFER_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "checkpoint.hpp"
+
+
+//!  Class BasicDelayRingBuffer
+/*!
+ This class contains the buffers jToAdd_ of all the neurons of a network in one ring buffer laid out as [slot][neuron] : the slot s contains the number of spikes each neuron will receive at the timeSteps t with t%nbSlots = s.
+ The number of slots is derived from the maximal delay : a spike sent at the time t is written in the slot of t+maxDelay, which must not be the one read at t, so there are maxDelay+1 slots.
+
+ Reading the current slot for all the neurons is a contiguous sweep over memory, and emptying it is a single memset.
+ The type of the cases is the Input of the PrecisionPolicy of the population (double or float), a buffer of float takes half the memory. The spike counters of a population are ring buffers of uint16_t.
+ */
+
+template<typename Value>
+class BasicDelayRingBuffer{
+
+    private:
+
+    size_t nbNeurons_; //!< Number of neurons (length of a slot)
+    size_t nbSlots_; //!< Number of slots (maximal delay + 1)
+    std::vector<Value> buffer_; //!< The nbSlots_ slots, one after the other
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Constructor of an empty ring buffer
+     */
+    BasicDelayRingBuffer();
+
+    /**
+     * Creates the slots, filled with 0
+     * @param nbNeurons is the number of neurons
+     * @param maxDelayInSteps is the maximal delay of the connections, in timeSteps
+     */
+    void resize(size_t const& nbNeurons, size_t const& maxDelayInSteps);
+
+    /**
+     * @return nbNeurons_
+     */
+    size_t getNbNeurons() const;
+    /**
+     * @return nbSlots_
+     */
+    size_t getNbSlots() const;
+
+    /*********************************************************************/
+
+    /**
+     * @param slot is the index of the slot
+     * @return a pointer on the case of the neuron 0 in the slot, the case of the neuron idx is at +idx
+     */
+    Value* getSlot(size_t const& slot);
+    /**
+     * @param slot is the index of the slot
+     * @return a pointer on the case of the neuron 0 in the slot, to read it
+     */
+    const Value* getSlot(size_t const& slot) const;
+
+    /**
+     * Empties the cases of the neurons first to last-1 in a slot (memset). Two ranges that don't overlap can be emptied at the same time by two threads
+     * @param slot is the index of the slot
+     * @param first is the index of the first neuron
+     * @param last is the index after the last neuron
+     */
+    void clear(size_t const& slot, size_t const& first, size_t const& last);
+
+    /**
+     * Writes the slots in a checkpoint
+     * @param writer is the checkpoint
+     */
+    void save(CheckpointWriter& writer) const;
+    /**
+     * Reads the slots from a checkpoint
+     * @param reader is the checkpoint
+     * @throw std::string if the slots don't match the number of neurons and of slots saved
+     */
+    void restore(CheckpointReader& reader);
+
+};
+
+typedef BasicDelayRingBuffer<double> DelayRingBuffer; //!< The buffers of the reference precision
+
+#endif
@@ -1,121 +1,226 @@
 #include "neuron.hpp"
 #include "network.hpp"
+#include "simulationConfig.hpp"
+#include "parameterSweep.hpp"
 #include <string>
 
 using namespace std;
 
-/**
- * Function that read all the parameters contained in "../param.in"
- * @return a vector containing the 5 parameters needed
- */
-vector<double> readParam();
-
-int main(){
-	
-    vector<double> param;
-    //Vector containing all the parameters useful for the simulation
-    try{
-        param = readParam();
+namespace {
+    
+    /**
+     * Compares the parameters given in the config with the ones of a restored network, which replace them : a parameter given on the command line that differs is an error, one of the config file is replaced with a message
+     * @param config contains the parameters of the simulation
+     * @param net is the network restored from config.getRestore()
+     * @return false if a parameter of the command line conflicts with the checkpoint
+     */
+    template<typename Precision>
+    bool checkRestoredParameters(SimulationConfig const& config, BasicNetwork<Precision> const& net){
         
-    }
-    catch(string errorMsg){
-        cerr << errorMsg ;
-        return 1;
+        struct Parameter{
+            const char* key; //!< Name of the parameter in the config
+            double given; //!< Value of the config
+            double restored; //!< Value of the checkpoint
+        };
+        PhysicsParameters const& physics(net.getPhysics());
+        const Parameter parameters[] = {
+            {"g", config.getG(), net.getG()},
+            {"eta", config.getEta(), net.getEta()},
+            {"neurons", double(config.getNbNeurons()), double(net.getNbNeurons())},
+            {"threads", double(config.getNbThreads()), double(net.getNbThreads())},
+            {"connectivity-seed", double(config.getConnectivitySeed()), double(net.getConnectivitySeed())},
+            {"spike-counters", double(config.getSpikeCounters()), double(net.getSpikeCounters())},
+            {"procedural-connectivity", double(config.getProceduralConnectivity()), double(net.getProceduralConnectivity())},
+            {"compact-connectivity", double(config.getCompactConnectivity()), double(net.getCompactConnectivity())},
+            {"h", config.getPhysics().getH(), physics.getH()},
+            {"delay", config.getPhysics().getDelay(), physics.getDelay()},
+            {"Je", config.getPhysics().getJe(), physics.getJe()},
+            {"tau", config.getPhysics().getTau(), physics.getTau()},
+            {"epsilon", config.getPhysics().getEpsilon(), physics.getEpsilon()}
+        };
+        
+        bool valid(true);
+        for(auto const& parameter : parameters){
+            std::string origin(config.getOrigin(parameter.key));
+            if(origin.empty() or parameter.given == parameter.restored)
+                continue;
+            if(origin == "command line"){
+                cerr << "Invalid argument: --" << parameter.key << " " << parameter.given << " conflicts with the checkpoint " << config.getRestore() << " (" << parameter.restored << ")" << endl;
+                valid = false;
+            }
+            else
+                cout << parameter.key << " = " << parameter.given << " (" << origin << ") replaced by " << parameter.restored << " of the checkpoint" << endl;
+        }
+        
+        //The mode of the connections comes from the checkpoint
+        if(net.getDelivery() == SpikeGather::Pull and (net.getProceduralConnectivity() or net.getCompactConnectivity())){
+            cerr << "Invalid argument: The connections of the checkpoint " << config.getRestore() << " can't be pulled, they have no list of sources" << endl;
+            valid = false;
+        }
+        return valid;
     }
     
-    //Affectation of these parameters into clearer names
-    double g(param[0]), eta(param[1]);
-    int nbNeurons(param[2]), Start(param[3]), Stop(param[4]);
-    
-    assert(h>0);
-    //We create a network of g, vratio and nb neurons, with backgroundNoise
-    Network net(true, g, eta, nbNeurons);
-    //The network creates the number of neurons it should contain
-    net.createNetwork();
-
-    //Change ms into timesteps
-    double Stopstep = static_cast<unsigned long>(ceil(Stop/h));
-    //Change ms into timesteps
-    double Startstep = static_cast<unsigned long>(ceil(Start/h));
-    //The simulation run for the number of steps given
-    net.updateNetwork(Startstep, Stopstep);
+    /**
+     * Simulates the network of a config (which is not a sweep) with the neurons in a precision
+     * @param config contains the parameters of the simulation
+     * @return the exit code of the program
+     */
+    template<typename Precision>
+    int simulate(SimulationConfig const& config){
+        
+        PhysicsParameters physics(config.getPhysics());
     
-	return 0;
-
-}
-
+        //We create a network of g, vratio and nb neurons, with backgroundNoise
+        BasicNetwork<Precision> net(true, config.getG(), config.getEta(), config.getNbNeurons(), physics);
+        //The update of the network is shared between nbThreads threads
+        net.setNbThreads(config.getNbThreads());
+        //The excitatory and the inhibitory spikes are counted in 16 bits instead of being summed
+        net.setSpikeCounters(config.getSpikeCounters());
+        //The targets of a neuron are computed when it spikes instead of being stored
+        net.setProceduralConnectivity(config.getProceduralConnectivity());
+        //The targets of a neuron are stored as differences of 16 bits instead of indexes of 32 bits
+        net.setCompactConnectivity(config.getCompactConnectivity());
+        //The spikes are pushed by the sources or pulled by the targets
+        net.setDelivery(config.getDelivery());
+        net.getGather().setPullThreshold(config.getPullThreshold());
+        //The seed of the background noise is random if it is not given
+        if(config.hasSeed())
+            net.setNoiseSeed(config.getSeed());
+        //The same seed of the connections always gives the same network, which can be kept in a cache
+        if(config.hasConnectivitySeed())
+            net.setConnectivitySeed(config.getConnectivitySeed());
+        net.setConnectivityCache(config.getConnectivityCache());
+        //An empty output means that the spikes are not written
+        net.setSpikesFileName(config.getOutput());
+        if(!config.getStatistics().empty())
+            net.enableStatistics(config.getBinSteps());
+        //The spikes are written by a dedicated I/O thread
+        net.setAsynchronousOutput(true);
+        if(config.getRestore().empty()){
+            //The network creates the number of neurons it should contain
+            net.createNetwork();
+            ConnectivityTimings const& timings(net.getConnectivityTimings());
+            if(net.getProceduralConnectivity())
+                cout << "Procedural connections : " << net.getProceduralConnections().getNbSynapses() << " synapses, not stored" << endl;
+            else if(timings.loaded)
+                cout << "Connections read from the cache in " << timings.loadTime << " s" << endl;
+            else
+                cout << "Connections generated in " << timings.drawTime + timings.sortTime << " s (draws " << timings.drawTime << " s, sort " << timings.sortTime << " s, " << timings.nbThreads << " threads)" << endl;
+        }
+        else {
+            //The network continues from a saved state, a new seed starts a new branch of the noise
+            try{
+                net.restoreCheckpoint(config.getRestore());
+            }
+            catch(string errorMsg){
+                cerr << errorMsg << endl;
+                return 1;
+            }
+            if(!checkRestoredParameters(config, net))
+                return 1;
+            if(config.hasSeed())
+                net.setNoiseSeed(config.getSeed());
+            cout << "Restored from " << config.getRestore() << " at the timeStep " << net.getGlobalClock() << endl;
+        }
+        cout << "Membrane kernel : " << net.neurons.getKernel().getName() << ", precision : " << Precision::getName() << (net.getSpikeCounters() ? ", spike counters" : "") << ", delivery : " << SpikeGather::getName(net.getDelivery()) << (net.getDelivery() == SpikeGather::Automatic ? ", pull threshold " + to_string(net.getGather().getPullThreshold()) : "") << endl;
 
-vector<double> readParam() {
+        //Change ms into timesteps
+        double Stopstep = static_cast<unsigned long>(ceil(config.getStop()/net.getPhysics().getH()));
+        //Change ms into timesteps
+        double Startstep = static_cast<unsigned long>(ceil(config.getStart()/net.getPhysics().getH()));
+        //The simulation run for the number of steps given
+        net.updateNetwork(Startstep, Stopstep);
     
-    //Opening of the parameters file
-    ifstream read;
-    read.open("../param.in");
-    //Test if the opening went well
-    assert(!read.fail());
+        //Report on the output, to see if the disk kept up with the simulation
+        net.closeSpikesFile();
+        net.printSpikesStatistics(cout);
+        if(net.getDelivery() == SpikeGather::Automatic)
+            cout << net.getNbPulledSteps() << " timeSteps pulled out of " << Stopstep - Startstep << endl;
+        //Where the memory went : neurons, connections, sources and spikes
+        net.printMemoryUsage(cout);
     
-    //Vector that will contain the parameters
-    std::vector<double> param (5, 0);
+        //Where the time went, if the phases are measured (NEURON_PROFILING)
+        if(RunProfile::isEnabled())
+            net.getProfile().print(cout);
+        if(!config.getProfile().empty()){
+            try{
+                net.getProfile().writeJson(config.getProfile());
+            }
+            catch(string errorMsg){
+                cerr << errorMsg << endl;
+                return 1;
+            }
+        }
     
-    for(size_t i(0); i < param.size() ; ++i){
-        //Reading of all the parameters
-        read >> param[i] ;
-        
-         string error("Invalid argument: ");
-        //Test that the parameters are positive numbers
-        if( (read.fail() ) or (param[i] < 0) ){
-            
-            
-            if(i==0 or i==1){
-                switch (i){
-                    case 0:
-                        error += "G ";
-                        break;
-                    case 1:
-                        error += "Eta ";
-                        break;
-        
-                        
-                }
-                error += "must be a positive real number" ;
-                
+        //State at the end of the simulation, to continue it or branch from it later
+        if(!config.getCheckpoint().empty()){
+            try{
+                net.saveCheckpoint(config.getCheckpoint());
             }
-            else{
-                switch (i){
-                    
-                    case 2:
-                        error += " The number of neurons ";
-                        break;
-                    case 3:
-                        error += " The start time ";
-                        break;
-                    case 4:
-                        error +=  " The stop time ";
-                        break;
-                    
-                }
-                error +=  " must be a positive integer number";
+            catch(string errorMsg){
+                cerr << errorMsg << endl;
+                return 1;
             }
-            
-           throw(error);
         }
-        //Test that the number of neurons is more than 50
-        else if (i==2 and param[i] < 50){
-            cout << param[3];
-            error += " Not enough neurons in the simulation for the chosen ration 0.8:0.2 excitatory:inhibitory. At least 50. " ;
-          throw(error);
-            
+    
+        //Summary of the firing of the network
+        if(!config.getStatistics().empty()){
+            SpikeStatistics const& statistics(net.getStatistics());
+            cout << "Mean rate : " << statistics.getMeanRate(net.getPhysics().getH()) << " Hz, mean CV of the ISIs : " << statistics.getMeanCV() << endl;
+            try{
+                statistics.write(config.getStatistics(), net.getSpikeFileHeader());
+            }
+            catch(string errorMsg){
+                cerr << errorMsg << endl;
+                return 1;
+            }
         }
-        //Test that the start time is smaller than the stop time
-        else if (i==4 and param[4] < param[3]){
-            error += " The stop time must be bigger than the start time. ";
-            throw(error);
+    
+        
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[]){
+	
+    //Help on the options of the command line
+    for(int i(1) ; i < argc ; ++i){
+        if(string(argv[i]) == "--help"){
+            cout << SimulationConfig::getUsage();
+            return 0;
         }
+    }
+    
+    //All the parameters of the simulation : ../param.in (or --config), overridden by the command line
+    SimulationConfig config;
+    try{
+        config = SimulationConfig::fromCommandLine(argc, argv);
         
     }
-    //Closing of the flow
-    read.close();
+    catch(string errorMsg){
+        cerr << errorMsg << endl;
+        return 1;
+    }
     
-    return param;
+    //Sweep mode : all the points of the grid (g, eta) with the same connections
+    if(config.isSweep()){
+        ParameterSweep sweep(config);
+        cout << "Parameter sweep : " << sweep.getNbPoints() << " points, " << config.getSweepJobs() << " at a time" << endl;
+        sweep.run(cout);
+        try{
+            sweep.writeSummary();
+        }
+        catch(string errorMsg){
+            cerr << errorMsg << endl;
+            return 1;
+        }
+        return 0;
+    }
+    
+    //The neurons and their buffers in the precision chosen
+    if(config.getPrecision() == SinglePrecision::getName())
+        return simulate<SinglePrecision>(config);
+    if(config.getPrecision() == MixedPrecision::getName())
+        return simulate<MixedPrecision>(config);
+    return simulate<DoublePrecision>(config);
 }
-
-
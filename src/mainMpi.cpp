@@ -0,0 +1,151 @@
+#include "network.hpp"
+#include "simulationConfig.hpp"
+#include "spikeExchange.hpp"
+#include <mpi.h>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+    /**
+     * Simulates the part of the network of a config that belongs to this process, with the neurons in a precision
+     * @param config contains the parameters of the simulation, the same in all the processes
+     * @param exchange connects this process to the other ones
+     * @return the exit code of the program
+     */
+    template<typename Precision>
+    int simulate(SimulationConfig const& config, SpikeExchange const& exchange){
+
+        PhysicsParameters physics(config.getPhysics());
+        bool master(exchange.getRank() == 0);
+
+        //All the processes need the same seeds, the random ones are drawn by the process 0
+        unsigned long int seeds[2] = {config.getSeed(), config.getConnectivitySeed()};
+        if(master){
+            std::random_device rd;
+            if(!config.hasSeed())
+                seeds[0] = rd();
+            if(!config.hasConnectivitySeed())
+                seeds[1] = rd();
+        }
+        MPI_Bcast(seeds, 2, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+
+        //The threads of each process update its ranges of neurons
+        BasicNetwork<Precision> net(true, config.getG(), config.getEta(), config.getNbNeurons(), seeds[1], seeds[0], physics);
+        net.setNbThreads(config.getNbThreads());
+        net.setExchange(exchange);
+        net.setSpikeCounters(config.getSpikeCounters());
+        net.setProceduralConnectivity(config.getProceduralConnectivity());
+        net.setCompactConnectivity(config.getCompactConnectivity());
+        net.setDelivery(config.getDelivery());
+        net.getGather().setPullThreshold(config.getPullThreshold());
+        //Each process writes the spikes of its neurons in its own file, merged by SpikeMerge
+        net.setSpikesFileName(SpikeExchange::getRankFileName(config.getOutput(), exchange.getRank()));
+        if(!config.getStatistics().empty())
+            net.enableStatistics(config.getBinSteps());
+        net.setAsynchronousOutput(true);
+
+        //Each process only generates the connections that reach its neurons
+        net.createNetwork();
+        ConnectivityTimings const& timings(net.getConnectivityTimings());
+        if(master)
+            cout << exchange.getNbProcesses() << " processes of " << net.getNbThreads() << " threads, connections of the process 0 generated in " << timings.drawTime + timings.sortTime << " s (" << net.neuronConnections_.getNbSynapses() << " synapses stored)" << endl;
+
+        double Stopstep = static_cast<unsigned long>(ceil(config.getStop()/net.getPhysics().getH()));
+        double Startstep = static_cast<unsigned long>(ceil(config.getStart()/net.getPhysics().getH()));
+        std::chrono::steady_clock::time_point begin(std::chrono::steady_clock::now());
+        net.updateNetwork(Startstep, Stopstep);
+        double time(std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count());
+        net.closeSpikesFile();
+
+        unsigned long int nbSpikes(exchange.sum(net.getNbRecordedSpikes()));
+        if(master){
+            cout << nbSpikes << " spikes in " << time << " s" << endl;
+            if(!config.getOutput().empty())
+                cout << "Spikes of each process in " << SpikeExchange::getRankFileName(config.getOutput(), 0) << "..., merged by SpikeMerge " << exchange.getNbProcesses() << " " << config.getOutput() << endl;
+        }
+
+        //The statistics of the neurons of all the processes, written by the process 0
+        if(!config.getStatistics().empty()){
+            SpikeStatistics statistics(net.getStatistics());
+            statistics.reduce(exchange);
+            if(master){
+                cout << "Mean rate : " << statistics.getMeanRate(net.getPhysics().getH()) << " Hz, mean CV of the ISIs : " << statistics.getMeanCV() << endl;
+                try{
+                    statistics.write(config.getStatistics(), net.getSpikeFileHeader());
+                }
+                catch(string errorMsg){
+                    cerr << errorMsg << endl;
+                    return 1;
+                }
+            }
+        }
+
+        return 0;
+    }
+
+    /**
+     * Parses the config and simulates the part of the network of this process
+     * @param argc is the number of arguments of the command line
+     * @param argv are the arguments of the command line
+     * @param exchange connects this process to the other ones
+     * @return the exit code of the program
+     */
+    int run(int argc, char* argv[], SpikeExchange const& exchange){
+
+        for(int i(1) ; i < argc ; ++i){
+            if(string(argv[i]) == "--help"){
+                if(exchange.getRank() == 0)
+                    cout << SimulationConfig::getUsage();
+                return 0;
+            }
+        }
+
+        //The same config in all the processes, so that they all stop on the same error
+        SimulationConfig config;
+        try{
+            config = SimulationConfig::fromCommandLine(argc, argv);
+        }
+        catch(string errorMsg){
+            if(exchange.getRank() == 0)
+                cerr << errorMsg << endl;
+            return 1;
+        }
+        if(config.isSweep() or !config.getRestore().empty() or !config.getCheckpoint().empty()){
+            if(exchange.getRank() == 0)
+                cerr << "NeuronMPI simulates one point, without sweep, checkpoint or restore" << endl;
+            return 1;
+        }
+
+        if(config.getPrecision() == SinglePrecision::getName())
+            return simulate<SinglePrecision>(config, exchange);
+        if(config.getPrecision() == MixedPrecision::getName())
+            return simulate<MixedPrecision>(config, exchange);
+        return simulate<DoublePrecision>(config, exchange);
+    }
+}
+
+/**
+ * Distributed simulation : each of the processes launched by mpirun updates a part of the network (see SpikeExchange)
+ * Usage : mpirun -n [number of processes] NeuronMPI [the options of Neuron], threads is the number of threads of each process
+ */
+int main(int argc, char* argv[]){
+
+    //Only the thread 0 of each process calls MPI
+    int provided(0);
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    if(provided < MPI_THREAD_FUNNELED){
+        cerr << "The MPI library doesn't support the threads" << endl;
+        MPI_Finalize();
+        return 1;
+    }
+
+    int code(run(argc, argv, SpikeExchange::world()));
+
+    MPI_Finalize();
+    return code;
+}
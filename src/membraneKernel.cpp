@@ -0,0 +1,499 @@
+#include "membraneKernel.hpp"
+#include "../Utility/Constants.h"
+#include <cassert>
+
+//The vector versions need x86 intrinsics and the target attribute of gcc and clang
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MEMBRANE_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+    //!  Struct BufferInput
+    /*!
+     The inputs of a block read in a buffer of the precision (double or float) : the sums of the spikes received, 1 per excitatory spike and -g per inhibitory spike
+     */
+    template<typename Value>
+    struct BufferInput{
+
+        const Value* values; //!< The case of the first neuron of the block
+
+        /**
+         * @param i is the index of a neuron in the block
+         * @return its input, in the type State
+         */
+        template<typename State>
+        State get(size_t const& i) const{
+
+            return State(values[i]);
+        }
+
+        /**
+         * @param i is the index of a neuron in the block
+         * @return the inputs of the block that begins at this neuron
+         */
+        BufferInput offset(size_t const& i) const{
+
+            BufferInput input = {values + i};
+            return input;
+        }
+    };
+
+    //!  Struct CountInput
+    /*!
+     The inputs of a block read in the counters of excitatory and inhibitory spikes (see BasicNeuronPopulation::setSpikeCounters) : the input is excitatory - g*inhibitory
+     */
+    struct CountInput{
+
+        const uint16_t* excitatory; //!< The counter of excitatory spikes of the first neuron of the block
+        const uint16_t* inhibitory; //!< The counter of inhibitory spikes of the first neuron of the block
+        double g; //!< Weight of an inhibitory spike
+
+        /**
+         * @param i is the index of a neuron in the block
+         * @return its input, in the type State
+         */
+        template<typename State>
+        State get(size_t const& i) const{
+
+            return State(excitatory[i]) - State(g)*State(inhibitory[i]);
+        }
+
+        /**
+         * @param i is the index of a neuron in the block
+         * @return the inputs of the block that begins at this neuron
+         */
+        CountInput offset(size_t const& i) const{
+
+            CountInput input = {excitatory + i, inhibitory + i, g};
+            return input;
+        }
+    };
+
+    /**
+     * Scalar version : one neuron at a time, exactly like NeuronPopulation::update. The operations are done in the type State, the input is converted to State
+     */
+    template<typename State, typename Input>
+    void integrateScalar(State* membranePotential, State* timeSpike, const State* I, Input const& input, size_t const& nb, double const& time, size_t const& firstIndex, PhysicsParameters const& physics, std::vector<uint32_t>& spiking){
+
+        const State t(time);
+        const State refractoryTimeStep(physics.getRefractoryTimeStep());
+        const State scalarCste1(physics.getScalarCste1());
+        const State scalarCste2(physics.getScalarCste2());
+        const State Je(physics.getJe());
+
+        for(size_t i(0) ; i < nb ; ++i){
+
+            // The neuron is in a refractory state, nothing happens
+            if (std::abs(t-timeSpike[i]) < refractoryTimeStep)
+                continue;
+
+            // If the membrane potential is bigger than the threshold, the neuron spikes and is reset
+            if(membranePotential[i] >= State(threshold)){
+                membranePotential[i] = Vreset;
+                timeSpike[i] = t;
+                spiking.push_back(firstIndex + i);
+            }
+            else {
+                membranePotential[i] = scalarCste1*membranePotential[i] + I[i]*scalarCste2 + input.template get<State>(i)*Je;
+            }
+        }
+    }
+
+#ifdef MEMBRANE_KERNEL_X86
+
+    /**
+     * Pushes the indexes of the bits set in a mask of spikes
+     * @param mask has the bit k set if the neuron first+k has spiked
+     * @param first is the index in the population of the neuron of the bit 0
+     * @param spiking receives the indexes
+     */
+    inline void pushSpikes(unsigned int mask, size_t const& first, std::vector<uint32_t>& spiking){
+
+        while(mask != 0){
+            spiking.push_back(first + __builtin_ctz(mask));
+            //Removes the lowest bit set
+            mask &= mask - 1;
+        }
+    }
+
+    /**
+     * Loads the inputs of 4 neurons as doubles
+     */
+    __attribute__((target("avx2")))
+    inline __m256d loadInput4(BufferInput<double> const& input, size_t const& i){
+
+        return _mm256_loadu_pd(input.values + i);
+    }
+
+    /**
+     * Loads the inputs of 4 neurons in float and converts them to double (exact)
+     */
+    __attribute__((target("avx2")))
+    inline __m256d loadInput4(BufferInput<float> const& input, size_t const& i){
+
+        return _mm256_cvtps_pd(_mm_loadu_ps(input.values + i));
+    }
+
+    /**
+     * Loads the counters of 4 neurons and weights them in double
+     */
+    __attribute__((target("avx2")))
+    inline __m256d loadInput4(CountInput const& input, size_t const& i){
+
+        __m256d excitatory(_mm256_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(input.excitatory + i)))));
+        __m256d inhibitory(_mm256_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(input.inhibitory + i)))));
+        return _mm256_sub_pd(excitatory, _mm256_mul_pd(_mm256_set1_pd(input.g), inhibitory));
+    }
+
+    /**
+     * AVX2 version in double : 4 neurons at a time, the end of the block with the scalar version. The inputs are buffers in double or in float, or counters
+     */
+    template<typename Input>
+    __attribute__((target("avx2")))
+    void integrateAVX2(double* membranePotential, double* timeSpike, const double* I, Input const& input, size_t const& nb, double const& time, size_t const& firstIndex, PhysicsParameters const& physics, std::vector<uint32_t>& spiking){
+
+        const __m256d vTime(_mm256_set1_pd(time));
+        const __m256d vRefractory(_mm256_set1_pd(physics.getRefractoryTimeStep()));
+        const __m256d vThreshold(_mm256_set1_pd(threshold));
+        const __m256d vReset(_mm256_set1_pd(Vreset));
+        const __m256d vCste1(_mm256_set1_pd(physics.getScalarCste1()));
+        const __m256d vCste2(_mm256_set1_pd(physics.getScalarCste2()));
+        const __m256d vJe(_mm256_set1_pd(physics.getJe()));
+        const __m256d signBit(_mm256_set1_pd(-0.0));
+
+        size_t i(0);
+        for(; i + 4 <= nb ; i += 4){
+            __m256d V(_mm256_loadu_pd(membranePotential + i));
+            __m256d ts(_mm256_loadu_pd(timeSpike + i));
+
+            //Not refractory : !(|time-timeSpike| < refractoryTimeStep)
+            __m256d distance(_mm256_andnot_pd(signBit, _mm256_sub_pd(vTime, ts)));
+            __m256d active(_mm256_cmp_pd(distance, vRefractory, _CMP_NLT_UQ));
+            //Spike : not refractory and above the threshold
+            __m256d fire(_mm256_and_pd(active, _mm256_cmp_pd(V, vThreshold, _CMP_GE_OQ)));
+            //Integration : not refractory and below the threshold
+            __m256d integrate(_mm256_andnot_pd(fire, active));
+
+            //scalarCste1*V + I*scalarCste2 + nbSpikes*Je, in the order of the scalar version
+            __m256d newV(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(vCste1, V), _mm256_mul_pd(_mm256_loadu_pd(I + i), vCste2)), _mm256_mul_pd(loadInput4(input, i), vJe)));
+
+            V = _mm256_blendv_pd(V, newV, integrate);
+            V = _mm256_blendv_pd(V, vReset, fire);
+            ts = _mm256_blendv_pd(ts, vTime, fire);
+            _mm256_storeu_pd(membranePotential + i, V);
+            _mm256_storeu_pd(timeSpike + i, ts);
+
+            pushSpikes(_mm256_movemask_pd(fire), firstIndex + i, spiking);
+        }
+
+        integrateScalar(membranePotential + i, timeSpike + i, I + i, input.offset(i), nb - i, time, firstIndex + i, physics, spiking);
+    }
+
+    /**
+     * Loads the inputs of 8 neurons as doubles
+     */
+    __attribute__((target("avx512f")))
+    inline __m512d loadInput8(BufferInput<double> const& input, size_t const& i){
+
+        return _mm512_loadu_pd(input.values + i);
+    }
+
+    /**
+     * Loads the inputs of 8 neurons in float and converts them to double (exact)
+     */
+    __attribute__((target("avx512f")))
+    inline __m512d loadInput8(BufferInput<float> const& input, size_t const& i){
+
+        //The zero-masked conversion, _mm512_cvtps_pd warns about an uninitialized register with gcc 12
+        return _mm512_maskz_cvtps_pd(0xFF, _mm256_loadu_ps(input.values + i));
+    }
+
+    /**
+     * Loads the counters of 8 neurons and weights them in double
+     */
+    __attribute__((target("avx512f")))
+    inline __m512d loadInput8(CountInput const& input, size_t const& i){
+
+        //Zero-masked conversions, like loadInput8 of the floats
+        __m512d excitatory(_mm512_maskz_cvtepi32_pd(0xFF, _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input.excitatory + i)))));
+        __m512d inhibitory(_mm512_maskz_cvtepi32_pd(0xFF, _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input.inhibitory + i)))));
+        return _mm512_sub_pd(excitatory, _mm512_mul_pd(_mm512_set1_pd(input.g), inhibitory));
+    }
+
+    /**
+     * Loads the inputs of 8 neurons in float
+     */
+    __attribute__((target("avx2")))
+    inline __m256 loadInput8f(BufferInput<float> const& input, size_t const& i){
+
+        return _mm256_loadu_ps(input.values + i);
+    }
+
+    /**
+     * Loads the counters of 8 neurons and weights them in float
+     */
+    __attribute__((target("avx2")))
+    inline __m256 loadInput8f(CountInput const& input, size_t const& i){
+
+        __m256 excitatory(_mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input.excitatory + i)))));
+        __m256 inhibitory(_mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input.inhibitory + i)))));
+        return _mm256_sub_ps(excitatory, _mm256_mul_ps(_mm256_set1_ps(input.g), inhibitory));
+    }
+
+    /**
+     * Loads the inputs of 16 neurons in float
+     */
+    __attribute__((target("avx512f")))
+    inline __m512 loadInput16f(BufferInput<float> const& input, size_t const& i){
+
+        return _mm512_loadu_ps(input.values + i);
+    }
+
+    /**
+     * Loads the counters of 16 neurons and weights them in float
+     */
+    __attribute__((target("avx512f")))
+    inline __m512 loadInput16f(CountInput const& input, size_t const& i){
+
+        //Zero-masked conversions, like loadInput8 of the floats
+        __m512 excitatory(_mm512_maskz_cvtepi32_ps(0xFFFF, _mm512_maskz_cvtepu16_epi32(0xFFFF, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input.excitatory + i)))));
+        __m512 inhibitory(_mm512_maskz_cvtepi32_ps(0xFFFF, _mm512_maskz_cvtepu16_epi32(0xFFFF, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input.inhibitory + i)))));
+        return _mm512_sub_ps(excitatory, _mm512_mul_ps(_mm512_set1_ps(input.g), inhibitory));
+    }
+
+    /**
+     * AVX-512 version in double : 8 neurons at a time, the end of the block with the scalar version. The inputs are buffers in double or in float, or counters
+     */
+    template<typename Input>
+    __attribute__((target("avx512f")))
+    void integrateAVX512(double* membranePotential, double* timeSpike, const double* I, Input const& input, size_t const& nb, double const& time, size_t const& firstIndex, PhysicsParameters const& physics, std::vector<uint32_t>& spiking){
+
+        const __m512d vTime(_mm512_set1_pd(time));
+        const __m512d vRefractory(_mm512_set1_pd(physics.getRefractoryTimeStep()));
+        const __m512d vThreshold(_mm512_set1_pd(threshold));
+        const __m512d vReset(_mm512_set1_pd(Vreset));
+        const __m512d vCste1(_mm512_set1_pd(physics.getScalarCste1()));
+        const __m512d vCste2(_mm512_set1_pd(physics.getScalarCste2()));
+        const __m512d vJe(_mm512_set1_pd(physics.getJe()));
+
+        size_t i(0);
+        for(; i + 8 <= nb ; i += 8){
+            __m512d V(_mm512_loadu_pd(membranePotential + i));
+            __m512d ts(_mm512_loadu_pd(timeSpike + i));
+
+            //Not refractory : !(|time-timeSpike| < refractoryTimeStep)
+            __mmask8 active(_mm512_cmp_pd_mask(_mm512_abs_pd(_mm512_sub_pd(vTime, ts)), vRefractory, _CMP_NLT_UQ));
+            //Spike : not refractory and above the threshold
+            __mmask8 fire(_mm512_mask_cmp_pd_mask(active, V, vThreshold, _CMP_GE_OQ));
+            //Integration : not refractory and below the threshold
+            __mmask8 integrate(active & ~fire);
+
+            //scalarCste1*V + I*scalarCste2 + nbSpikes*Je, in the order of the scalar version
+            __m512d newV(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(vCste1, V), _mm512_mul_pd(_mm512_loadu_pd(I + i), vCste2)), _mm512_mul_pd(loadInput8(input, i), vJe)));
+
+            V = _mm512_mask_blend_pd(integrate, V, newV);
+            V = _mm512_mask_blend_pd(fire, V, vReset);
+            ts = _mm512_mask_blend_pd(fire, ts, vTime);
+            _mm512_storeu_pd(membranePotential + i, V);
+            _mm512_storeu_pd(timeSpike + i, ts);
+
+            pushSpikes(fire, firstIndex + i, spiking);
+        }
+
+        integrateScalar(membranePotential + i, timeSpike + i, I + i, input.offset(i), nb - i, time, firstIndex + i, physics, spiking);
+    }
+
+    /**
+     * AVX2 version in float : 8 neurons at a time, the end of the block with the scalar version. The inputs are a buffer in float or counters
+     */
+    template<typename Input>
+    __attribute__((target("avx2")))
+    void integrateAVX2(float* membranePotential, float* timeSpike, const float* I, Input const& input, size_t const& nb, double const& time, size_t const& firstIndex, PhysicsParameters const& physics, std::vector<uint32_t>& spiking){
+
+        const __m256 vTime(_mm256_set1_ps(time));
+        const __m256 vRefractory(_mm256_set1_ps(physics.getRefractoryTimeStep()));
+        const __m256 vThreshold(_mm256_set1_ps(threshold));
+        const __m256 vReset(_mm256_set1_ps(Vreset));
+        const __m256 vCste1(_mm256_set1_ps(physics.getScalarCste1()));
+        const __m256 vCste2(_mm256_set1_ps(physics.getScalarCste2()));
+        const __m256 vJe(_mm256_set1_ps(physics.getJe()));
+        const __m256 signBit(_mm256_set1_ps(-0.0f));
+
+        size_t i(0);
+        for(; i + 8 <= nb ; i += 8){
+            __m256 V(_mm256_loadu_ps(membranePotential + i));
+            __m256 ts(_mm256_loadu_ps(timeSpike + i));
+
+            //Same masks as the version in double
+            __m256 distance(_mm256_andnot_ps(signBit, _mm256_sub_ps(vTime, ts)));
+            __m256 active(_mm256_cmp_ps(distance, vRefractory, _CMP_NLT_UQ));
+            __m256 fire(_mm256_and_ps(active, _mm256_cmp_ps(V, vThreshold, _CMP_GE_OQ)));
+            __m256 integrate(_mm256_andnot_ps(fire, active));
+
+            __m256 newV(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vCste1, V), _mm256_mul_ps(_mm256_loadu_ps(I + i), vCste2)), _mm256_mul_ps(loadInput8f(input, i), vJe)));
+
+            V = _mm256_blendv_ps(V, newV, integrate);
+            V = _mm256_blendv_ps(V, vReset, fire);
+            ts = _mm256_blendv_ps(ts, vTime, fire);
+            _mm256_storeu_ps(membranePotential + i, V);
+            _mm256_storeu_ps(timeSpike + i, ts);
+
+            pushSpikes(_mm256_movemask_ps(fire), firstIndex + i, spiking);
+        }
+
+        integrateScalar(membranePotential + i, timeSpike + i, I + i, input.offset(i), nb - i, time, firstIndex + i, physics, spiking);
+    }
+
+    /**
+     * AVX-512 version in float : 16 neurons at a time, the end of the block with the scalar version. The inputs are a buffer in float or counters
+     */
+    template<typename Input>
+    __attribute__((target("avx512f")))
+    void integrateAVX512(float* membranePotential, float* timeSpike, const float* I, Input const& input, size_t const& nb, double const& time, size_t const& firstIndex, PhysicsParameters const& physics, std::vector<uint32_t>& spiking){
+
+        const __m512 vTime(_mm512_set1_ps(time));
+        const __m512 vRefractory(_mm512_set1_ps(physics.getRefractoryTimeStep()));
+        const __m512 vThreshold(_mm512_set1_ps(threshold));
+        const __m512 vReset(_mm512_set1_ps(Vreset));
+        const __m512 vCste1(_mm512_set1_ps(physics.getScalarCste1()));
+        const __m512 vCste2(_mm512_set1_ps(physics.getScalarCste2()));
+        const __m512 vJe(_mm512_set1_ps(physics.getJe()));
+
+        size_t i(0);
+        for(; i + 16 <= nb ; i += 16){
+            __m512 V(_mm512_loadu_ps(membranePotential + i));
+            __m512 ts(_mm512_loadu_ps(timeSpike + i));
+
+            //Same masks as the version in double
+            __mmask16 active(_mm512_cmp_ps_mask(_mm512_abs_ps(_mm512_sub_ps(vTime, ts)), vRefractory, _CMP_NLT_UQ));
+            __mmask16 fire(_mm512_mask_cmp_ps_mask(active, V, vThreshold, _CMP_GE_OQ));
+            __mmask16 integrate(active & ~fire);
+
+            __m512 newV(_mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(vCste1, V), _mm512_mul_ps(_mm512_loadu_ps(I + i), vCste2)), _mm512_mul_ps(loadInput16f(input, i), vJe)));
+
+            V = _mm512_mask_blend_ps(integrate, V, newV);
+            V = _mm512_mask_blend_ps(fire, V, vReset);
+            ts = _mm512_mask_blend_ps(fire, ts, vTime);
+            _mm512_storeu_ps(membranePotential + i, V);
+            _mm512_storeu_ps(timeSpike + i, ts);
+
+            pushSpikes(fire, firstIndex + i, spiking);
+        }
+
+        integrateScalar(membranePotential + i, timeSpike + i, I + i, input.offset(i), nb - i, time, firstIndex + i, physics, spiking);
+    }
+
+#endif
+
+    /**
+     * Integrates a block with the version of an instruction set, in the precision of the arrays
+     * @param instructions is an instruction set available on the processor
+     * @param input reads the inputs of the block (BufferInput or CountInput)
+     */
+    template<typename State, typename Input>
+    void integrateWith(MembraneKernel::Instructions const& instructions, State* membranePotential, State* timeSpike, const State* I, Input const& input, size_t const& nb, double const& time, size_t const& firstIndex, PhysicsParameters const& physics, std::vector<uint32_t>& spiking){
+
+        assert(MembraneKernel::isAvailable(instructions));
+
+        switch(instructions){
+#ifdef MEMBRANE_KERNEL_X86
+            case MembraneKernel::AVX512:
+                integrateAVX512(membranePotential, timeSpike, I, input, nb, time, firstIndex, physics, spiking);
+                break;
+            case MembraneKernel::AVX2:
+                integrateAVX2(membranePotential, timeSpike, I, input, nb, time, firstIndex, physics, spiking);
+                break;
+#endif
+            default:
+                integrateScalar(membranePotential, timeSpike, I, input, nb, time, firstIndex, physics, spiking);
+        }
+    }
+}
+
+/*********************************************************************/
+
+MembraneKernel::MembraneKernel()
+: instructions_(getBestAvailable())
+{}
+
+MembraneKernel::MembraneKernel(Instructions const& instructions)
+: instructions_(instructions)
+{
+    assert(isAvailable(instructions_));
+}
+
+bool MembraneKernel::isAvailable(Instructions const& instructions){
+
+    switch(instructions){
+        case Scalar:
+            return true;
+#ifdef MEMBRANE_KERNEL_X86
+        case AVX2:
+            return __builtin_cpu_supports("avx2");
+        case AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+    }
+}
+
+MembraneKernel::Instructions MembraneKernel::getBestAvailable(){
+
+    if(isAvailable(AVX512))
+        return AVX512;
+    if(isAvailable(AVX2))
+        return AVX2;
+    return Scalar;
+}
+
+MembraneKernel::Instructions MembraneKernel::getInstructions() const{
+
+    return instructions_;
+}
+
+std::string MembraneKernel::getName() const{
+
+    switch(instructions_){
+        case AVX2:
+            return "AVX2";
+        case AVX512:
+            return "AVX-512";
+        default:
+            return "scalar";
+    }
+}
+
+/*********************************************************************/
+
+void MembraneKernel::integrate(double* membranePotential, double* timeSpike, const double* I, const double* input, size_t const& nb, double const& time, size_t const& firstIndex, PhysicsParameters const& physics, std::vector<uint32_t>& spiking) const{
+
+    BufferInput<double> buffer = {input};
+    integrateWith(instructions_, membranePotential, timeSpike, I, buffer, nb, time, firstIndex, physics, spiking);
+}
+
+void MembraneKernel::integrate(double* membranePotential, double* timeSpike, const double* I, const float* input, size_t const& nb, double const& time, size_t const& firstIndex, PhysicsParameters const& physics, std::vector<uint32_t>& spiking) const{
+
+    BufferInput<float> buffer = {input};
+    integrateWith(instructions_, membranePotential, timeSpike, I, buffer, nb, time, firstIndex, physics, spiking);
+}
+
+void MembraneKernel::integrate(float* membranePotential, float* timeSpike, const float* I, const float* input, size_t const& nb, double const& time, size_t const& firstIndex, PhysicsParameters const& physics, std::vector<uint32_t>& spiking) const{
+
+    BufferInput<float> buffer = {input};
+    integrateWith(instructions_, membranePotential, timeSpike, I, buffer, nb, time, firstIndex, physics, spiking);
+}
+
+void MembraneKernel::integrate(double* membranePotential, double* timeSpike, const double* I, const uint16_t* excitatory, const uint16_t* inhibitory, double const& g, size_t const& nb, double const& time, size_t const& firstIndex, PhysicsParameters const& physics, std::vector<uint32_t>& spiking) const{
+
+    CountInput counts = {excitatory, inhibitory, g};
+    integrateWith(instructions_, membranePotential, timeSpike, I, counts, nb, time, firstIndex, physics, spiking);
+}
+
+void MembraneKernel::integrate(float* membranePotential, float* timeSpike, const float* I, const uint16_t* excitatory, const uint16_t* inhibitory, double const& g, size_t const& nb, double const& time, size_t const& firstIndex, PhysicsParameters const& physics, std::vector<uint32_t>& spiking) const{
+
+    CountInput counts = {excitatory, inhibitory, g};
+    integrateWith(instructions_, membranePotential, timeSpike, I, counts, nb, time, firstIndex, physics, spiking);
+}
@@ -0,0 +1,114 @@
+#ifndef MEMBRANE_KERNEL_H
+#define MEMBRANE_KERNEL_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include "physicsParameters.hpp"
+
+
+//!  Class MembraneKernel
+/*!
+ This class integrates the membrane potential of a contiguous block of neurons during one timeStep, with the same dynamics as Neuron::update :
+ a neuron in its refractory period does nothing, a neuron above the threshold spikes and is reset to Vreset, the other ones follow V = scalarCste1*V + I*scalarCste2 + nbSpikes*Je, with the constants of a PhysicsParameters.
+
+ The block is processed 4 neurons at a time with AVX2, or 8 neurons at a time with AVX-512 : the refractory mask, the threshold crossing mask and the reset are computed in vector form, then the indexes of the neurons that have spiked are extracted from the mask.
+ The instructions are chosen at runtime according to the processor (the best available by default), with a scalar fallback. The additions and multiplications are done in the same order in the three versions (no fused multiply-add), so that they give bit-identical results.
+
+ The kernel exists for the three precisions of PrecisionPolicy : double potentials and buffers, float potentials and buffers (8 neurons at a time with AVX2 and 16 with AVX-512, the constants are rounded to float), and double potentials with float buffers (converted to double when they are loaded).
+ The inputs can also be read in two counters of 16 bits per neuron, of the excitatory and of the inhibitory spikes, weighted by 1 and -g when they are loaded.
+ */
+
+class MembraneKernel{
+
+    public:
+
+    //!  Enum Instructions
+    /*!
+     The instruction sets of the kernel
+     */
+    enum Instructions{
+        Scalar, //!< One neuron at a time, available everywhere
+        AVX2, //!< 4 neurons at a time (8 in float)
+        AVX512 //!< 8 neurons at a time (16 in float)
+    };
+
+    private:
+
+    Instructions instructions_; //!< The instruction set used
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Constructor of a kernel using the best instruction set of the processor
+     */
+    MembraneKernel();
+    /**
+     * Constructor of a kernel using a given instruction set, which has to be available
+     * @param instructions is the instruction set
+     */
+    MembraneKernel(Instructions const& instructions);
+
+    /**
+     * @param instructions is an instruction set
+     * @return true if the processor (and the compiler) supports instructions
+     */
+    static bool isAvailable(Instructions const& instructions);
+    /**
+     * @return the best instruction set supported by the processor
+     */
+    static Instructions getBestAvailable();
+
+    /**
+     * @return instructions_
+     */
+    Instructions getInstructions() const;
+    /**
+     * @return the name of the instruction set ("scalar", "AVX2" or "AVX-512")
+     */
+    std::string getName() const;
+
+    /*********************************************************************/
+
+    /**
+     * Integrates the neurons of a block of one timeStep
+     * @param membranePotential are the membrane potentials of the block, updated
+     * @param timeSpike are the times of the last spike of the block, updated
+     * @param I are the external currents of the block
+     * @param input are the numbers of spikes received by the neurons of the block during this timeStep
+     * @param nb is the number of neurons of the block
+     * @param time is the global time
+     * @param firstIndex is the index of the first neuron of the block in the population
+     * @param physics contains the constants of the membrane equation
+     * @param spiking receives (push_back) the indexes in the population of the neurons that have spiked, in increasing order
+     */
+    void integrate(double* membranePotential, double* timeSpike, const double* I, const double* input, size_t const& nb, double const& time, size_t const& firstIndex, PhysicsParameters const& physics, std::vector<uint32_t>& spiking) const;
+    /**
+     * Integrates the neurons of a block of one timeStep, with buffers in float (MixedPrecision)
+     */
+    void integrate(double* membranePotential, double* timeSpike, const double* I, const float* input, size_t const& nb, double const& time, size_t const& firstIndex, PhysicsParameters const& physics, std::vector<uint32_t>& spiking) const;
+    /**
+     * Integrates the neurons of a block of one timeStep, in float (SinglePrecision)
+     */
+    void integrate(float* membranePotential, float* timeSpike, const float* I, const float* input, size_t const& nb, double const& time, size_t const& firstIndex, PhysicsParameters const& physics, std::vector<uint32_t>& spiking) const;
+    /**
+     * Integrates the neurons of a block of one timeStep, with the counters of excitatory and inhibitory spikes instead of a buffer : the input of a neuron is excitatory - g*inhibitory
+     * @param excitatory are the numbers of excitatory spikes (background noise included) received by the neurons of the block
+     * @param inhibitory are the numbers of inhibitory spikes received by the neurons of the block
+     * @param g is the weight of an inhibitory spike
+     */
+    void integrate(double* membranePotential, double* timeSpike, const double* I, const uint16_t* excitatory, const uint16_t* inhibitory, double const& g, size_t const& nb, double const& time, size_t const& firstIndex, PhysicsParameters const& physics, std::vector<uint32_t>& spiking) const;
+    /**
+     * Integrates the neurons of a block of one timeStep in float, with the counters of excitatory and inhibitory spikes
+     */
+    void integrate(float* membranePotential, float* timeSpike, const float* I, const uint16_t* excitatory, const uint16_t* inhibitory, double const& g, size_t const& nb, double const& time, size_t const& firstIndex, PhysicsParameters const& physics, std::vector<uint32_t>& spiking) const;
+
+};
+
+#endif
@@ -1,17 +1,16 @@
 #include "network.hpp"
 #include "neuron.hpp"
+#include "connectivityGenerator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
 
 
 
-void Network::createNetwork(){
+template<typename Precision>
+void BasicNetwork<Precision>::createNetwork(){
    
-    //Ensures no other network has been made before this one and that the 2 vectors have the appropriate length
-    neurons.resize(0);
-    neurons.resize(getNbNeurons());
-    neuronConnections_.resize(0);
-    neuronConnections_.resize(getNbNeurons());
-    
-    
     //Test if the number of excitatory neurons is more than 0
     assert(getNbExcitatory()>1);
     //Test if the number of inhibitory neurons is more than 0
@@ -20,125 +19,262 @@ void Network::createNetwork(){
     assert(getNbInhibitory()+getNbExcitatory()==getNbNeurons());
     assert(getNbExcitatory()>getNbInhibitory());
     
-    //Number of excitatory connections each neuron receives
-    double ce(epsilon*getNbExcitatory());
-    //Number of inhibitory connections each neuron receives
-    double ci(epsilon*getNbInhibitory());
-    
-    //Creation of nbExcitatory neurons
-    for(size_t i(0) ; i < getNbExcitatory() ; ++i){
+    //Creation of nbExcitatory excitatory neurons followed by nbInhibitory inhibitory neurons
+    neurons.resize(getNbNeurons(), getNbExcitatory());
+    gather_.reset();
 
-        //Creation of an excitatory neuron with background noise
-        Neuron* neuron(new Neuron(true));
-        //Puts neuron in the vector of neurons
-        neurons[i] = neuron;
+    //Creation of the links between neurons. Each neuron receives epsilon*getNbExcitatory excitatory and epsilon*getNbInhibitory inhibitory connections
+    ConnectivityGenerator generator(getNbExcitatory(), getNbInhibitory(), getPhysics().getEpsilon(), connectivitySeed_);
+    if(proceduralConnectivity_){
+        //Nothing is stored, the targets are computed when the sources spike
+        createProceduralConnections();
+        connectivityTimings_ = ConnectivityTimings();
+        connectivityTimings_.nbThreads = 1;
     }
-
-    //Creation of nbInhibitory neurons
-    for(size_t i(getNbExcitatory()) ; i < getNbNeurons() ; ++i){
-
-        //Creation of an inhibitory neuron with background noise
-        Neuron* neuron(new Neuron(false));
-        //Put neuron in the vector of neurons
-        neurons[i] = neuron;
+    else if(exchange_.isDistributed()){
+        //Each process only generates the connections that reach its neurons, they are never cached
+        neuronConnections_ = generator.generate(getRangeBegin(getFirstRange()), getRangeBegin(getFirstRange() + getNbThreads()));
+        connectivityTimings_ = generator.getTimings();
+    }
+    else if(connectivityCache_.empty()){
+        neuronConnections_ = generator.generate();
+        connectivityTimings_ = generator.getTimings();
+    }
+    else {
+        //The connections of a previous run with the same key are memory-mapped instead of being generated
+        ConnectivityCache cache(connectivityCache_);
+        neuronConnections_ = cache.get(generator);
+        connectivityTimings_ = generator.getTimings();
+        connectivityTimings_.loaded = cache.wasLoaded();
+        connectivityTimings_.loadTime = cache.getLoadTime();
+    }
+    
+    //The stored connections are encoded, then released
+    if(compactConnectivity_){
+        compactConnections_ = CompactConnectivity(neuronConnections_);
+        neuronConnections_ = Connectivity();
     }
+}
 
-    //Creation of the links between neurons
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> distributionExcitatory(0,getNbExcitatory()-1);
-    std::uniform_int_distribution<int> distributionInhibitory(getNbExcitatory(), neurons.size()-1);
+template<typename Precision>
+void BasicNetwork<Precision>::createNetwork(Connectivity const& connections){
+    
+    //The procedural connections are not stored, the ones of the same seed are computed again
+    assert(connections.size() == (proceduralConnectivity_ ? 0 : getNbNeurons()));
+    
+    neurons.resize(getNbNeurons(), getNbExcitatory());
+    //The arrays of the connections are shared, not copied
+    neuronConnections_ = connections;
+    if(proceduralConnectivity_)
+        createProceduralConnections();
+    if(compactConnectivity_){
+        compactConnections_ = CompactConnectivity(connections);
+        neuronConnections_ = Connectivity();
+    }
+    gather_.reset();
+}
 
-    //Iterates on every neurons
-    for(size_t idxNeuron(0); idxNeuron < getNbNeurons() ; ++idxNeuron){
+template<typename Precision>
+void BasicNetwork<Precision>::createProceduralConnections(){
+    
+    //As many connections as the stored ones, spread over the targets of each source
+    ConnectivityGenerator generator(getNbExcitatory(), getNbInhibitory(), getPhysics().getEpsilon(), connectivitySeed_);
+    neuronConnections_ = Connectivity();
+    proceduralConnections_ = ProceduralConnectivity(getNbNeurons(), generator.getNbExcitatorySources() + generator.getNbInhibitorySources(), connectivitySeed_);
+}
 
-        //Randomly chooses 0.1*getNbExcitatory excitatory neurons of index idx that will have "idxNeuron" in their targets
-        for(size_t j(0); j < ce ; ++j){
-            size_t idx = distributionExcitatory(gen);
-            //Adds the target of index "idxNeuron" to the targets of neuron idx
-            neuronConnections_[idx].push_back(idxNeuron);
-        }
-        //Randomly chooses 0.1*getNbInhibitory inhibitory neurons that will have "idxNeuron" in their targets
-        for(size_t j(0); j < ci ; ++j){
-            size_t idx = distributionInhibitory(gen);
-            //Add the target of index "idxNeuron" to the targets of neuron idx
-            neuronConnections_[idx].push_back(idxNeuron);
-        }
-        
-    }
+template<typename Precision>
+bool BasicNetwork<Precision>::areConnectionsStored() const{
     
+    return !proceduralConnectivity_ and !compactConnectivity_;
 }
 
 
 
 /*********************************************************************/
 
-bool Network::getBackgroundNoise() const{
+template<typename Precision>
+bool BasicNetwork<Precision>::getBackgroundNoise() const{
     
     return BackgroundNoise_;
 }
-unsigned int Network::getCe() const{
+template<typename Precision>
+unsigned int BasicNetwork<Precision>::getCe() const{
     return Ce_;
 }
 
-double Network::getEta() const{
+template<typename Precision>
+double BasicNetwork<Precision>::getEta() const{
     
     return Eta_;
 }
 
-double Network::getG() const{
+template<typename Precision>
+double BasicNetwork<Precision>::getG() const{
     
     return g_;
 }
 
-unsigned long int Network::getGlobalClock() const{
+template<typename Precision>
+unsigned long int BasicNetwork<Precision>::getGlobalClock() const{
     
     return GlobalClock_;
 }
 
-size_t Network::getJidxToRead() const{
+template<typename Precision>
+size_t BasicNetwork<Precision>::getJidxToRead() const{
     
     return jIdxToRead_;
 }
-size_t Network::getJidxToWrite() const{
+template<typename Precision>
+size_t BasicNetwork<Precision>::getJidxToWrite() const{
     
     return jIdxToWrite_;
 }
-unsigned long int Network::getNbNeurons() const{
+template<typename Precision>
+unsigned long int BasicNetwork<Precision>::getNbNeurons() const{
     
     return nbNeurons_;
 }
 
-unsigned long int Network::getNbExcitatory() const{
+template<typename Precision>
+unsigned long int BasicNetwork<Precision>::getNbExcitatory() const{
     
     return nbExcitatory_;
 }
-unsigned long int Network::getNbInhibitory() const{
+template<typename Precision>
+unsigned long int BasicNetwork<Precision>::getNbInhibitory() const{
     
     return nbInhibitory_;
 }
-double Network::getVext() const{
+template<typename Precision>
+double BasicNetwork<Precision>::getVext() const{
     return Vext_;
 }
 
+template<typename Precision>
+unsigned int BasicNetwork<Precision>::getNbThreads() const{
+    
+    return nbThreads_;
+}
+
+template<typename Precision>
+size_t BasicNetwork<Precision>::getNbRanges() const{
+    
+    return getNbThreads()*exchange_.getNbProcesses();
+}
+
+template<typename Precision>
+size_t BasicNetwork<Precision>::getFirstRange() const{
+    
+    return getNbThreads()*exchange_.getRank();
+}
+
+template<typename Precision>
+size_t BasicNetwork<Precision>::getRangeBegin(size_t const& range) const{
+    
+    return range*getNbNeurons()/getNbRanges();
+}
+
+template<typename Precision>
+ProceduralConnectivity const& BasicNetwork<Precision>::getProceduralConnections() const{
+    
+    return proceduralConnections_;
+}
+
+template<typename Precision>
+CompactConnectivity const& BasicNetwork<Precision>::getCompactConnections() const{
+    
+    return compactConnections_;
+}
+
+template<typename Precision>
+SpikeExchange const& BasicNetwork<Precision>::getExchange() const{
+    
+    return exchange_;
+}
+
+template<typename Precision>
+unsigned long int BasicNetwork<Precision>::getNoiseSeed() const{
+    
+    return noiseSeed_;
+}
+
+template<typename Precision>
+unsigned long int BasicNetwork<Precision>::getNbRecordedSpikes() const{
+    
+    return nbRecordedSpikes_;
+}
+
+template<typename Precision>
+RunProfile const& BasicNetwork<Precision>::getProfile() const{
+    
+    return profile_;
+}
+
+template<typename Precision>
+unsigned long int BasicNetwork<Precision>::getConnectivitySeed() const{
+    
+    return connectivitySeed_;
+}
+
+template<typename Precision>
+ConnectivityTimings const& BasicNetwork<Precision>::getConnectivityTimings() const{
+    
+    return connectivityTimings_;
+}
+
+template<typename Precision>
+SpikeStatistics const& BasicNetwork<Precision>::getStatistics() const{
+    
+    return statistics_;
+}
+
+template<typename Precision>
+SpikeFileHeader BasicNetwork<Precision>::getSpikeFileHeader() const{
+    
+    SpikeFileHeader header = {getPhysics().getH(), static_cast<uint32_t>(getNbNeurons()), getG(), getEta(), getNoiseSeed(), getConnectivitySeed()};
+    return header;
+}
+
+template<typename Precision>
+PhysicsParameters const& BasicNetwork<Precision>::getPhysics() const{
+    
+    return neurons.getPhysics();
+}
+
                        
 /*********************************************************************/
 
-Network::Network(bool const& backgroundNoise, double const& g, double const& Eta, double const& nbNeurons)
-: BackgroundNoise_(backgroundNoise), g_(g), GlobalClock_(0), jIdxToRead_(0), jIdxToWrite_ (DelayInSteps), nbNeurons_(nbNeurons), Eta_(Eta)
+namespace {
+    
+    /**
+     * @return a random seed, different at each run
+     */
+    unsigned long int randomSeed(){
+        
+        std::random_device rd;
+        return rd();
+    }
+}
+
+template<typename Precision>
+BasicNetwork<Precision>::BasicNetwork(bool const& backgroundNoise, double const& g, double const& Eta, double const& nbNeurons, PhysicsParameters const& physics)
+: BasicNetwork(backgroundNoise, g, Eta, nbNeurons, randomSeed(), randomSeed(), physics)
+{}
+
+template<typename Precision>
+BasicNetwork<Precision>::BasicNetwork(bool const& backgroundNoise, double const& g, double const& Eta, double const& nbNeurons, unsigned long int const& connectivitySeed, unsigned long int const& noiseSeed, PhysicsParameters const& physics)
+: BackgroundNoise_(backgroundNoise), g_(g), GlobalClock_(0), jIdxToRead_(0), jIdxToWrite_ (physics.getDelayInSteps()), nbNeurons_(nbNeurons), Eta_(Eta), delivery_(SpikeGather::Push), proceduralConnectivity_(false), compactConnectivity_(false), nbThreads_(1), noiseSeed_(noiseSeed), connectivitySeed_(connectivitySeed), connectivityTimings_(), spikesFileName_("../result/spikes.bin"), nbRecordedSpikes_(0), nbPulledSteps_(0), statisticsBinSteps_(0), statisticsStarted_(false)
 {
-    // Open the stream that writes the time at which a neuron spikes and its ID
-    spikes.open("../result/spikes");
-    assert(!spikes.fail());
-    // Initialisation of the random devices
-    std::random_device rd;
-    randomGen_ = std::mt19937(rd());
+    //The neurons use the same parameters as the network
+    neurons.setPhysics(physics);
     
     if(getNbNeurons() > 50){
         //Set the number of excitatory and inhibitory
         setNbExcitatory(0.8*getNbNeurons());
         setNbInhibitory(0.2*getNbNeurons());
-        unsigned int ce =epsilon*getNbExcitatory();
+        unsigned int ce =getPhysics().getEpsilon()*getNbExcitatory();
         setCe(ce);
         
     }
@@ -147,68 +283,357 @@ Network::Network(bool const& backgroundNoise, double const& g, double const& Eta
        
         // Calculation of the Vext, from the Vratio given (Vratio = Vext/Vthr)
         // Vthr = threshold/(Ce*J*tau) is the frequency at which the neuron spikes, in absence of backgroundNoise
-        double Vthr(threshold/(getCe()*Je*tau));
+        double Vthr(threshold/(getCe()*getPhysics().getJe()*getPhysics().getTau()));
         // Vext = Eta*Ce*Vthr
         setVext(getEta()*getCe()*Vthr);
-        
-        // Initialisation of the poisson distribution
-        poissonDistr_ = std::poisson_distribution<>(getVext()*h);
 
     }
+    
+    // Initialisation of the generators of the background noise
+    initRandomGens();
 
 }
 
-Network::~Network(){
-    
-    assert(!neurons.empty());
-    //deallocation of the memory
-    for(auto neuron : neurons){
-        if(neuron!=nullptr)
-            delete neuron;
-    }
+template<typename Precision>
+BasicNetwork<Precision>::~BasicNetwork(){
     
     //Close the file at the end of the simulation
     spikes.close();
     
 }
 
-void Network::setCe(unsigned int& ce){
+template<typename Precision>
+void BasicNetwork<Precision>::setCe(unsigned int& ce){
     
     Ce_=ce;
 }
 
-void Network::setNbExcitatory(unsigned long int const& nb){
+template<typename Precision>
+void BasicNetwork<Precision>::setNbExcitatory(unsigned long int const& nb){
     
     nbExcitatory_= nb;
 }
 
-void Network::setNbInhibitory(unsigned long int const& nb){
+template<typename Precision>
+void BasicNetwork<Precision>::setNbInhibitory(unsigned long int const& nb){
     
     nbInhibitory_= nb;
 }
 
-void Network::setVext(double const& newV){
+template<typename Precision>
+void BasicNetwork<Precision>::setVext(double const& newV){
     
     Vext_ = newV;
 }
+
+template<typename Precision>
+void BasicNetwork<Precision>::setNbThreads(unsigned int const& nb){
+    
+    assert(nb > 0);
+    nbThreads_ = nb;
+    initRandomGens();
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::setExchange(SpikeExchange const& exchange){
+    
+    //The connections are generated by createNetwork for the neurons of the process
+    assert(neurons.empty());
+    exchange_ = exchange;
+    initRandomGens();
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::setAsynchronousOutput(bool const& b){
+    
+    spikes.setAsynchronous(b);
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::setSpikesFileName(std::string const& fileName){
+    
+    assert(!spikes.isOpen());
+    spikesFileName_ = fileName;
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::enableStatistics(unsigned long int const& binSteps){
+    
+    assert(binSteps > 0 and !statisticsStarted_);
+    statisticsBinSteps_ = binSteps;
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::setDelivery(SpikeGather::Mode const& mode){
+    
+    delivery_ = mode;
+}
+
+template<typename Precision>
+SpikeGather::Mode BasicNetwork<Precision>::getDelivery() const{
+    
+    return delivery_;
+}
+
+template<typename Precision>
+unsigned long int BasicNetwork<Precision>::getNbPulledSteps() const{
+    
+    return nbPulledSteps_;
+}
+
+template<typename Precision>
+SpikeGather& BasicNetwork<Precision>::getGather(){
+    
+    return gather_;
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::setSpikeCounters(bool const& b){
+    
+    //The buffers are allocated by createNetwork
+    assert(neurons.empty());
+    neurons.setSpikeCounters(b, getG());
+}
+
+template<typename Precision>
+bool BasicNetwork<Precision>::getSpikeCounters() const{
+    
+    return neurons.getSpikeCounters();
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::setConnectivitySeed(unsigned long int const& seed){
+    
+    connectivitySeed_ = seed;
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::setProceduralConnectivity(bool const& b){
+    
+    //The connections are created by createNetwork
+    assert(neurons.empty());
+    proceduralConnectivity_ = b;
+}
+
+template<typename Precision>
+bool BasicNetwork<Precision>::getProceduralConnectivity() const{
+    
+    return proceduralConnectivity_;
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::setCompactConnectivity(bool const& b){
+    
+    //The connections are encoded by createNetwork
+    assert(neurons.empty());
+    compactConnectivity_ = b;
+}
+
+template<typename Precision>
+bool BasicNetwork<Precision>::getCompactConnectivity() const{
+    
+    return compactConnectivity_;
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::setConnectivityCache(std::string const& directory){
+    
+    connectivityCache_ = directory;
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::setNoiseSeed(unsigned long int const& seed){
+    
+    noiseSeed_ = seed;
+    initRandomGens();
+}
+
+/*********************************************************************/
+
+template<typename Precision>
+void BasicNetwork<Precision>::initRandomGens(){
+    
+    noises_.clear();
+    noiseCounts_.assign(getNbThreads(), std::vector<unsigned int>());
+    
+    if(!getBackgroundNoise())
+        return;
+    
+    //The alias table is computed once, then copied in each range with its own independent stream
+    BackgroundNoise noise(getVext()*getPhysics().getH(), getNoiseSeed());
+    //The ranges of the other processes come first, the streams don't depend on the number of processes
+    for(size_t range(0) ; range < getFirstRange() ; ++range)
+        noise.getGenerator().jump();
+    for(size_t partition(0) ; partition < getNbThreads() ; ++partition){
+        noises_.push_back(noise);
+        //The stream of the next range begins 2^128 numbers later
+        noise.getGenerator().jump();
+    }
+}
                        
 /*********************************************************************/
 
 
-void Network::updateJIndex(){
+template<typename Precision>
+void BasicNetwork<Precision>::sendSpike(size_t const& source){
+    
+    sendSpike(source, 0, getNbNeurons(), jIdxToWrite_);
+}
+
+template<typename Precision>
+size_t BasicNetwork<Precision>::sendSpike(size_t const& source, size_t const& first, size_t const& last, size_t const& Jidx){
+    
+    if(proceduralConnectivity_)
+        return sendProceduralSpike(source, first, last, Jidx);
+    if(compactConnectivity_)
+        return sendCompactSpike(source, first, last, Jidx);
+    
+    Connectivity::TargetRange targets(neuronConnections_[source]);
+    
+    //The targets are sorted, the first one in the range is found with a binary search
+    const uint32_t* target(targets.begin());
+    if(first > 0)
+        target = std::lower_bound(targets.begin(), targets.end(), first);
+    
+    //Iteration on all neuron's targets that are in the range
+    const uint32_t* firstTarget(target);
+    if(neurons.getSpikeCounters()){
+        //The spike is counted with the other ones of its type, weighted when the targets read their counters
+        uint16_t* counts(neurons.getIsExcitatory(source) ? neurons.getExcitatoryCounts(Jidx) : neurons.getInhibitoryCounts(Jidx));
+        for(; target != targets.end() and *target < last ; ++target)
+            ++counts[*target];
+    }
+    else {
+        //1 if excitatory, -g if inhibitory
+        Input j(neurons.getIsExcitatory(source) ? 1 : -getG());
+        Input* buffers(neurons.getSlot(Jidx));
+        for(; target != targets.end() and *target < last ; ++target)
+            buffers[*target] += j;
+    }
+    
+    return target - firstTarget;
+}
+
+template<typename Precision>
+size_t BasicNetwork<Precision>::sendProceduralSpike(size_t const& source, size_t const& first, size_t const& last, size_t const& Jidx){
+    
+    //All the targets are computed, only the ones in the range receive the spike
+    const size_t nbTargets(proceduralConnections_.getNbTargets());
+    const size_t rangeSize(last - first);
+    size_t nbReceived(0);
+    if(neurons.getSpikeCounters()){
+        uint16_t* counts(neurons.getIsExcitatory(source) ? neurons.getExcitatoryCounts(Jidx) : neurons.getInhibitoryCounts(Jidx));
+        for(size_t k(0) ; k < nbTargets ; ++k){
+            size_t target(proceduralConnections_.getTarget(source, k));
+            if(target - first < rangeSize){
+                ++counts[target];
+                ++nbReceived;
+            }
+        }
+    }
+    else {
+        Input j(neurons.getIsExcitatory(source) ? 1 : -getG());
+        Input* buffers(neurons.getSlot(Jidx));
+        for(size_t k(0) ; k < nbTargets ; ++k){
+            size_t target(proceduralConnections_.getTarget(source, k));
+            if(target - first < rangeSize){
+                buffers[target] += j;
+                ++nbReceived;
+            }
+        }
+    }
+    
+    return nbReceived;
+}
+
+template<typename Precision>
+size_t BasicNetwork<Precision>::sendCompactSpike(size_t const& source, size_t const& first, size_t const& last, size_t const& Jidx){
+    
+    //The targets are decoded in increasing order, the ones before the range are skipped
+    CompactConnectivity::TargetReader targets(compactConnections_[source]);
+    size_t target(last);
+    while(targets.hasNext() and (target = targets.next()) < first){}
+    if(target < first)
+        return 0;
+    
+    size_t nbReceived(0);
+    if(neurons.getSpikeCounters()){
+        uint16_t* counts(neurons.getIsExcitatory(source) ? neurons.getExcitatoryCounts(Jidx) : neurons.getInhibitoryCounts(Jidx));
+        while(target < last){
+            ++counts[target];
+            ++nbReceived;
+            if(!targets.hasNext())
+                break;
+            target = targets.next();
+        }
+    }
+    else {
+        Input j(neurons.getIsExcitatory(source) ? 1 : -getG());
+        Input* buffers(neurons.getSlot(Jidx));
+        while(target < last){
+            buffers[target] += j;
+            ++nbReceived;
+            if(!targets.hasNext())
+                break;
+            target = targets.next();
+        }
+    }
+    
+    return nbReceived;
+}
+
+template<typename Precision>
+size_t BasicNetwork<Precision>::gatherSpikes(size_t const& partition, size_t const& first, size_t const& last, std::vector< std::vector<uint32_t> > const& spiking, size_t const& Jidx){
+    
+    gather_.markSpikes(partition, spiking);
+    
+    size_t nbReceived(0);
+    uint32_t nbExcitatory(0), nbInhibitory(0);
+    if(neurons.getSpikeCounters()){
+        uint16_t* excitatory(neurons.getExcitatoryCounts(Jidx));
+        uint16_t* inhibitory(neurons.getInhibitoryCounts(Jidx));
+        for(size_t idx(first) ; idx < last ; ++idx){
+            gather_.countSpikes(partition, idx, nbExcitatory, nbInhibitory);
+            excitatory[idx] += nbExcitatory;
+            inhibitory[idx] += nbInhibitory;
+            nbReceived += nbExcitatory + nbInhibitory;
+        }
+    }
+    else {
+        //The spikes are added one by one, excitatory first, like sendSpike does for the sources in increasing order
+        const Input j(-getG());
+        Input* buffers(neurons.getSlot(Jidx));
+        for(size_t idx(first) ; idx < last ; ++idx){
+            gather_.countSpikes(partition, idx, nbExcitatory, nbInhibitory);
+            Input buffer(buffers[idx]);
+            for(uint32_t k(0) ; k < nbExcitatory ; ++k)
+                buffer += 1;
+            for(uint32_t k(0) ; k < nbInhibitory ; ++k)
+                buffer += j;
+            buffers[idx] = buffer;
+            nbReceived += nbExcitatory + nbInhibitory;
+        }
+    }
+    
+    return nbReceived;
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::updateJIndex(){
     
     ++jIdxToRead_;
     //The index is back to 0
-    if(jIdxToRead_ > DelayInSteps)
+    if(jIdxToRead_ > getPhysics().getDelayInSteps())
         jIdxToRead_ = 0;
 
     ++jIdxToWrite_;
-    if(jIdxToWrite_ > DelayInSteps)
+    if(jIdxToWrite_ > getPhysics().getDelayInSteps())
         jIdxToWrite_ = 0;
     
 }
 
-void Network::updateNetwork(double const& StartStep, double const& StopStep){
+template<typename Precision>
+void BasicNetwork<Precision>::updateNetwork(double const& StartStep, double const& StopStep){
     
     //Some verifications
     assert(StartStep >= 0);
@@ -217,48 +642,413 @@ void Network::updateNetwork(double const& StartStep, double const& StopStep){
     
     //Check if there are neurons in the network
     assert(!neurons.empty());
+    assert(getNbRanges() <= getNbNeurons());
+    //The processes of a distributed simulation exchange their spikes with MPI
+    assert(!exchange_.isDistributed() or SpikeExchange::isAvailable());
+    //A counter receives at most the excitatory in-degree and the largest draw of the background noise during a timeStep
+    assert(!getSpikeCounters() or std::ceil(getPhysics().getEpsilon()*getNbExcitatory()) + (noises_.empty() ? 0 : noises_[0].getTableSize()) <= UINT16_MAX);
+    
+    //The procedural and the compact connections have no sources to pull from
+    assert(areConnectionsStored() or getDelivery() != SpikeGather::Pull);
+    assert(!proceduralConnectivity_ or !compactConnectivity_);
+    
+    //The sources of each neuron, transposed once for the connections of the network
+    if(areConnectionsStored() and (getDelivery() == SpikeGather::Pull or (getDelivery() == SpikeGather::Automatic and gather_.isPullPossible())))
+        gather_.prepare(neuronConnections_, getNbExcitatory(), getNbThreads());
+    
+    // Open the file that records the time at which a neuron spikes and its ID
+    if(!spikesFileName_.empty() and !spikes.isOpen())
+        spikes.open(spikesFileName_, getSpikeFileHeader());
+    
+    //The statistics begin with the first timeStep recorded
+    if(statisticsBinSteps_ > 0 and !statisticsStarted_){
+        statistics_.reset(getNbNeurons(), std::max<unsigned long int>(StartStep+1, getGlobalClock()), statisticsBinSteps_);
+        statisticsStarted_ = true;
+    }
+    
+    //The lists of the spikes of each range (of all the processes), for each timeStep of two windows
+    spiking_.assign(2*getWindowSteps(), std::vector< std::vector<uint32_t> >(getNbRanges()));
+    
+    ThreadBarrier barrier(getNbThreads());
+    profile_.prepare(getNbThreads(), getRangeBegin(getFirstRange() + getNbThreads()) - getRangeBegin(getFirstRange()));
+    unsigned long int firstStep(getGlobalClock());
+    std::chrono::steady_clock::time_point begin(std::chrono::steady_clock::now());
+    
+    //The ranges 1 to nbThreads_-1 are updated by new threads, the range 0 by this thread
+    std::vector<std::thread> threads;
+    for(size_t partition(1) ; partition < getNbThreads() ; ++partition)
+        threads.push_back(std::thread(&BasicNetwork::updatePartition, this, partition, StartStep, StopStep, std::ref(barrier)));
+    
+    updatePartition(0, StartStep, StopStep, barrier);
+    
+    for(auto& thread : threads)
+        thread.join();
+    
+    profile_.addRun(getGlobalClock() - firstStep, std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count());
+}
+
+template<typename Precision>
+size_t BasicNetwork<Precision>::deliverSpikes(size_t const& partition, size_t const& first, size_t const& last, std::vector< std::vector<uint32_t> > const& spiking, size_t const& Jidx){
+    
+    size_t nbSynapticEvents(0), nbSpikes(0);
+    for(auto const& range : spiking)
+        nbSpikes += range.size();
+    
+    //All the threads see the same spikes, so they choose the same mode
+    bool pull(areConnectionsStored() and (getDelivery() == SpikeGather::Pull or (getDelivery() == SpikeGather::Automatic and gather_.isPullFaster(nbSpikes, getNbNeurons()))));
+    if(pull and partition == 0)
+        ++nbPulledSteps_;
+    if(pull and nbSpikes > 0)
+        nbSynapticEvents = gatherSpikes(partition, first, last, spiking, Jidx);
+    else if(!pull){
+        for(auto const& range : spiking){
+            for(auto NeuronIndice : range)
+                nbSynapticEvents += sendSpike(NeuronIndice, first, last, Jidx);
+        }
+    }
+    
+    return nbSynapticEvents;
+}
+
+template<typename Precision>
+size_t BasicNetwork<Precision>::getWindowSteps() const{
+    
+    //A spike reaches its targets delayInSteps timeSteps later, at least 1
+    return std::max<size_t>(1, getPhysics().getDelayInSteps());
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::updatePartition(size_t const& partition, double const& StartStep, double const& StopStep, ThreadBarrier& barrier){
+    
+    //The range of neurons updated by this thread, among the ranges of all the processes
+    const size_t range(getFirstRange() + partition);
+    size_t first(getRangeBegin(range));
+    size_t last(getRangeBegin(range + 1));
+    
+    //Only the thread of the range 0 modifies the clock and the indexes, the others work on copies
+    unsigned long int clock(getGlobalClock());
+    size_t jIdxToRead(getJidxToRead()), jIdxToWrite(getJidxToWrite());
+    const size_t windowSteps(getWindowSteps());
+    size_t window(0);
     
     //The simulation stops at StopStep
-    while(getGlobalClock() < StopStep){
+    //Time of each phase, only measured with NEURON_PROFILING
+    RunProfile::ThreadCounters& counters(profile_.getThread(partition));
+    RunProfile::PhaseClock phases;
+    
+    while(clock < StopStep){
+        
+        phases.startStep();
         
-        for(size_t NeuronIndice(0) ; NeuronIndice < getNbNeurons() ; ++NeuronIndice){
+        //The lists of spikes of the windows alternate between the two halves of spiking_, so that this thread can fill the ones of this window while the others still read the ones of the previous window
+        std::vector< std::vector< std::vector<uint32_t> > >::iterator windowSpikes(spiking_.begin() + (window%2)*windowSteps);
+        const unsigned long int windowBegin(clock);
+        const size_t windowWrite(jIdxToWrite);
+        size_t nbSpikes(0);
+        
+        //No spike of this window reaches a neuron before the end of the window : the range is updated alone for windowSteps timeSteps
+        size_t nbSteps(0);
+        for(; nbSteps < windowSteps and clock < StopStep ; ++nbSteps){
             
-                //Add the backgroundNoise to the buffer
-                if(getBackgroundNoise())
-                    neurons[NeuronIndice] ->jToAdd_[jIdxToRead_] += poissonDistr_(randomGen_);
+            //Add the backgroundNoise to the buffer of each neuron of the range, at the index it reads during this timeStep
+            if(getBackgroundNoise()){
+                //All the draws of the range at once
+                std::vector<unsigned int>& counts(noiseCounts_[partition]);
+                counts.resize(last - first);
+                noises_[partition].fill(counts.data(), counts.size());
+                
+                //The spikes of the noise are excitatory
+                if(neurons.getSpikeCounters()){
+                    uint16_t* excitatory(neurons.getExcitatoryCounts(jIdxToRead) + first);
+                    for(size_t i(0) ; i < counts.size() ; ++i)
+                        excitatory[i] += counts[i];
+                }
+                else {
+                    Input* buffers(neurons.getSlot(jIdxToRead) + first);
+                    for(size_t i(0) ; i < counts.size() ; ++i)
+                        buffers[i] += counts[i];
+                }
+            }
+            phases.lap(counters, RunProfile::Noise);
             
-                //Update each neuron and give the index at which the neuron corresponding to neuronIndice should check its buffer
-                bool spike(neurons[NeuronIndice]->update(jIdxToRead_, getGlobalClock()));
+            //Update all the neurons of the range, they read their buffer at the index jIdxToRead
+            std::vector<uint32_t>& spiking(windowSpikes[nbSteps][range]);
+            neurons.updateRange(first, last, jIdxToRead, clock, spiking);
+            nbSpikes += spiking.size();
+            phases.lap(counters, RunProfile::Integration);
             
-                if(spike){
-                    //Iteration on all neuron's targets
-                    for(auto targetIndice : neuronConnections_[NeuronIndice] ){
-                        //If has spiked, will send an action potential and stock it into the buffer of the target, at the index jIdxToWrite
-                        if(neurons[NeuronIndice]->getIsExcitatory())
-                            //1 if excitatory
-                            neurons[targetIndice]->jToAdd_[jIdxToWrite_] += 1;
-                        else
-                            //-g if inhibitory
-                            neurons[targetIndice]->jToAdd_[jIdxToWrite_] += - getG();
-                    }
-                    
-                    //write the time and the id of the neuron that has spiked into a file
-                    if(getGlobalClock() > StartStep)
-                        spikes << getGlobalClock() << " " << NeuronIndice << std::endl ;
+            ++clock;
+            jIdxToRead = (jIdxToRead + 1)%neurons.getNbSlots();
+            jIdxToWrite = (jIdxToWrite + 1)%neurons.getNbSlots();
+        }
+        
+        //Waits until all the ranges have been updated until the end of the window
+        barrier.wait();
+        //The spikes of the other processes arrive in the lists of their ranges, before any thread delivers them
+        if(exchange_.isDistributed()){
+            if(partition == 0)
+                exchange_.exchange(windowSpikes, nbSteps, getNbThreads());
+            barrier.wait();
+        }
+        phases.lap(counters, RunProfile::Barrier);
+        
+        //The global clock updates after all the neurons already have, once all the threads have read it
+        for(size_t step(0) ; partition == 0 and step < nbSteps ; ++step){
+            updateTime();
+            //The indexes are updated too
+            updateJIndex();
+        }
+        
+        //Stock the action potentials of all the ranges and all the timeSteps of the window into the buffer of the targets of this range, at the index where each timeStep wrote
+        size_t nbSynapticEvents(0);
+        for(size_t step(0) ; step < nbSteps ; ++step)
+            nbSynapticEvents += deliverSpikes(partition, first, last, windowSpikes[step], (windowWrite + step)%neurons.getNbSlots());
+        phases.count(counters, nbSpikes, nbSynapticEvents);
+        phases.lap(counters, RunProfile::Delivery);
+        
+        //write the time and the id of the neurons of this process that have spiked into a file, timeStep after timeStep
+        for(size_t step(0) ; partition == 0 and step < nbSteps ; ++step){
+            unsigned long int time(windowBegin + step);
+            if(time <= StartStep)
+                continue;
+            if(statisticsStarted_){
+                statistics_.markStep(time);
+                for(size_t local(getFirstRange()) ; local < getFirstRange() + getNbThreads() ; ++local){
+                    for(auto NeuronIndice : windowSpikes[step][local])
+                        statistics_.record(time, NeuronIndice);
                 }
             }
+            for(size_t local(getFirstRange()) ; local < getFirstRange() + getNbThreads() ; ++local){
+                std::vector<uint32_t> const& spiking(windowSpikes[step][local]);
+                nbRecordedSpikes_ += spiking.size();
+                if(!spikes.isOpen())
+                    continue;
+                for(auto NeuronIndice : spiking)
+                    spikes.record(time, NeuronIndice);
+            }
+        }
+        phases.lap(counters, RunProfile::Output);
+        phases.endStep(counters);
+        ++window;
+    }
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::saveCheckpoint(std::string const& fileName) const{
+    
+    //The connections of a process are only the ones that reach its neurons
+    if(exchange_.isDistributed())
+        throw(std::string("A checkpoint can't be saved by a process of a distributed simulation"));
+    
+    //The state is written in a temporary file that replaces the old one at once : the connections of a restored network can be used in place in the mapping of the file that is replaced
+    std::string temporaryName(fileName + ".tmp");
+    try{
+        CheckpointWriter writer(temporaryName);
+        
+        //Parameters of the network, with fixed sizes
+        writer.write<uint8_t>(BackgroundNoise_);
+        writer.write(g_);
+        writer.write(Eta_);
+        writer.write(Vext_);
+        writer.write<uint32_t>(Ce_);
+        writer.write<uint64_t>(nbNeurons_);
+        writer.write<uint64_t>(nbExcitatory_);
+        writer.write<uint64_t>(nbInhibitory_);
+        writer.write(getPhysics().getH());
+        writer.write(getPhysics().getDelay());
+        writer.write(getPhysics().getJe());
+        writer.write(getPhysics().getTau());
+        writer.write(getPhysics().getEpsilon());
+    
+        //Time
+        writer.write<uint64_t>(GlobalClock_);
+        writer.write<uint64_t>(jIdxToRead_);
+        writer.write<uint64_t>(jIdxToWrite_);
+        writer.write<uint64_t>(nbRecordedSpikes_);
+    
+        neurons.save(writer);
+        //The procedural connections are computed again from the seed, the stored ones are empty. The compact ones replace the stored ones
+        writer.write<uint8_t>(proceduralConnectivity_);
+        writer.write<uint8_t>(compactConnectivity_);
+        neuronConnections_.save(writer);
+        if(compactConnectivity_)
+            compactConnections_.save(writer);
+    
+        //The random generators, one per range of neurons
+        writer.write<uint32_t>(nbThreads_);
+        writer.write<uint64_t>(noiseSeed_);
+        writer.write<uint64_t>(connectivitySeed_);
+        std::vector<uint64_t> states;
+        for(auto const& noise : noises_){
+            for(unsigned int i(0) ; i < 4 ; ++i)
+                states.push_back(noise.getGenerator().getState(i));
+        }
+        writer.writeArray(states.data(), states.size());
         
-        //The global clock updates after all the neurons already have
-        updateTime();
-        //The indexes are updated too
-        updateJIndex();
+        writer.close();
+    }
+    catch(std::string const&){
+        std::remove(temporaryName.c_str());
+        throw;
+    }
+    
+    if(std::rename(temporaryName.c_str(), fileName.c_str()) != 0){
+        std::remove(temporaryName.c_str());
+        throw(std::string("Impossible to write the checkpoint file ") + fileName);
+    }
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::restoreCheckpoint(std::string const& fileName){
+    
+    if(exchange_.isDistributed())
+        throw(std::string("A checkpoint can't be restored by a process of a distributed simulation"));
+    
+    CheckpointReader reader(fileName);
+    
+    //Everything is read and checked before the network is modified : a damaged checkpoint leaves the network as it was
+    uint8_t backgroundNoise(0), procedural(0), compact(0);
+    uint32_t ce(0), nbThreads(0);
+    uint64_t nbNeurons(0), nbExcitatory(0), nbInhibitory(0), clock(0), jIdxToRead(0), jIdxToWrite(0), nbRecordedSpikes(0), noiseSeed(0), connectivitySeed(0);
+    double g(0), eta(0), vext(0);
+    double physics[5];
+    
+    reader.read(backgroundNoise);
+    reader.read(g);
+    reader.read(eta);
+    reader.read(vext);
+    reader.read(ce);
+    reader.read(nbNeurons);
+    reader.read(nbExcitatory);
+    reader.read(nbInhibitory);
+    for(auto& parameter : physics)
+        reader.read(parameter);
+    if(nbNeurons == 0 or nbNeurons > UINT32_MAX or nbExcitatory + nbInhibitory != nbNeurons)
+        reader.fail("has inconsistent numbers of neurons");
+    if(!(physics[0] > 0) or !(physics[1] > 0) or !(physics[3] > 0) or !(physics[4] > 0 and physics[4] <= 1))
+        reader.fail("has invalid physical parameters");
+    
+    reader.read(clock);
+    reader.read(jIdxToRead);
+    reader.read(jIdxToWrite);
+    reader.read(nbRecordedSpikes);
+    
+    //The other settings of the population (kernel, external currents...) are kept
+    BasicNeuronPopulation<Precision> population(neurons);
+    population.setPhysics(PhysicsParameters(physics[0], physics[1], physics[2], physics[3], physics[4]));
+    population.restore(reader);
+    if(population.size() != nbNeurons)
+        reader.fail("doesn't contain the right number of neurons");
+    if(jIdxToRead >= population.getNbSlots() or jIdxToWrite >= population.getNbSlots())
+        reader.fail("has invalid indexes of the buffers");
+    
+    reader.read(procedural);
+    reader.read(compact);
+    if(procedural and compact)
+        reader.fail("has connections both procedural and compact");
+    Connectivity connections(Connectivity::restore(reader));
+    CompactConnectivity compactConnections(compact ? CompactConnectivity::restore(reader) : CompactConnectivity());
+    if(connections.size() != ((procedural or compact) ? 0 : nbNeurons) or compactConnections.size() != (compact ? nbNeurons : 0))
+        reader.fail("doesn't contain the right number of neurons");
+    //The connections are used in place : a damaged offset or target would make the spikes be written out of the buffers
+    if(!connections.isValid(nbNeurons) or !compactConnections.isValid(nbNeurons))
+        reader.fail("has inconsistent connections");
+    
+    reader.read(nbThreads);
+    reader.read(noiseSeed);
+    reader.read(connectivitySeed);
+    if(nbThreads == 0 or nbThreads > nbNeurons)
+        reader.fail("has an invalid number of threads");
+    
+    //One generator per range of neurons, with the background noise
+    uint64_t nbStates(0);
+    const uint64_t* states(reader.readArray<uint64_t>(nbStates));
+    if(nbStates != (backgroundNoise ? 4*nbThreads : 0))
+        reader.fail("doesn't contain the states of all the random generators");
+    
+    BackgroundNoise_ = backgroundNoise;
+    g_ = g;
+    Eta_ = eta;
+    Vext_ = vext;
+    Ce_ = ce;
+    nbNeurons_ = nbNeurons;
+    nbExcitatory_ = nbExcitatory;
+    nbInhibitory_ = nbInhibitory;
+    GlobalClock_ = clock;
+    jIdxToRead_ = jIdxToRead;
+    jIdxToWrite_ = jIdxToWrite;
+    nbRecordedSpikes_ = nbRecordedSpikes;
+    //The statistics begin again at the next update
+    statisticsStarted_ = false;
+    
+    neurons = std::move(population);
+    proceduralConnectivity_ = procedural;
+    compactConnectivity_ = compact;
+    neuronConnections_ = connections;
+    compactConnections_ = compactConnections;
+    gather_.reset();
+    
+    nbThreads_ = nbThreads;
+    noiseSeed_ = noiseSeed;
+    connectivitySeed_ = connectivitySeed;
+    if(proceduralConnectivity_)
+        createProceduralConnections();
+    
+    //The alias tables are computed again from Vext_, then the generators continue where they stopped
+    initRandomGens();
+    assert(nbStates == 4*noises_.size());
+    for(size_t partition(0) ; partition < noises_.size() ; ++partition){
+        for(unsigned int i(0) ; i < 4 ; ++i)
+            noises_[partition].getGenerator().setState(i, states[4*partition + i]);
     }
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::closeSpikesFile(){
+    
+    spikes.close();
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::printSpikesStatistics(std::ostream& out) const{
+    
+    if(spikesFileName_.empty())
+        out << "Spikes recorded : " << getNbRecordedSpikes() << " (not written)" << std::endl;
+    else
+        spikes.printStatistics(out);
+}
+
+template<typename Precision>
+void BasicNetwork<Precision>::printMemoryUsage(std::ostream& out) const{
+    
+    //The connections that are used by the network
+    size_t connections(neuronConnections_.getMemoryUsage() + compactConnections_.getMemoryUsage());
+    std::string kind(proceduralConnectivity_ ? "procedural" : (compactConnectivity_ ? "compact, 16 bits differences" : "stored, 32 bits targets"));
+    size_t nbSynapses(proceduralConnectivity_ ? proceduralConnections_.getNbSynapses() : (compactConnectivity_ ? compactConnections_.getNbSynapses() : neuronConnections_.getNbSynapses()));
     
+    size_t spikeLists(0);
+    for(auto const& step : spiking_){
+        for(auto const& range : step)
+            spikeLists += range.capacity()*sizeof(uint32_t);
+    }
     
+    size_t population(neurons.getMemoryUsage()), sources(gather_.getSources().getMemoryUsage());
+    const double MB(1e6);
+    out << "Memory of the network : " << (population + connections + sources + spikeLists)/MB << " MB" << std::endl;
+    out << "  neurons and buffers : " << population/MB << " MB" << std::endl;
+    out << "  connections (" << kind << ", " << nbSynapses << " synapses) : " << connections/MB << " MB" << std::endl;
+    out << "  sources of the pull delivery : " << sources/MB << " MB" << std::endl;
+    out << "  lists of the spikes : " << spikeLists/MB << " MB" << std::endl;
 }
 
-void Network::updateTime(){
+template<typename Precision>
+void BasicNetwork<Precision>::updateTime(){
     
     ++GlobalClock_;
     
 }
+
+//The networks of the precisions of PrecisionPolicy
+template class BasicNetwork<DoublePrecision>;
+template class BasicNetwork<SinglePrecision>;
+template class BasicNetwork<MixedPrecision>;
@@ -3,17 +3,45 @@
 
 #include <stdio.h>
 #include <fstream>
+#include <thread>
 #include "neuron.hpp"
+#include "neuronPopulation.hpp"
+#include "connectivity.hpp"
+#include "connectivityGenerator.hpp"
+#include "connectivityCache.hpp"
+#include "threadBarrier.hpp"
+#include "spikeRecorder.hpp"
+#include "spikeStatistics.hpp"
+#include "checkpoint.hpp"
+#include "runProfile.hpp"
+#include "backgroundNoise.hpp"
+#include "spikeGather.hpp"
+#include "spikeExchange.hpp"
+#include "proceduralConnectivity.hpp"
+#include "compactConnectivity.hpp"
+#include <ostream>
 
 
-//!  Class Network
+//!  Class BasicNetwork
 /*!
  This class models a network of many neurons. It creates as many neurons as you want to, handle the globalClock of the simulation and update itself (so it updates all the neurons of the simulation) of the number of timeSteps you want.
- It handles all the connections between the neuron with its attribute neuronConnections. It contains all the neurons of the simulation (in form of index), and each of them has a vector of indexTarget (index that correspond to targets). It also has a vector with all the neurons (pointers).
+ It handles all the connections between the neuron with its attribute neuronConnections. It contains all the neurons of the simulation (in form of index), and each of them has a vector of indexTarget (index that correspond to targets). The state of all the neurons is stored in a NeuronPopulation, in contiguous arrays indexed by the neuron id.
  During the update, it handles the Poisson distribution and fills the buffer of the neurons.
+ The whole state of a simulation (parameters, clock, indexes, neurons, buffers, connections and states of the random generators) can be saved in a checkpoint and restored, the restored network continues exactly like the saved one.
+ The precision of the neurons and of the buffers is the PrecisionPolicy given as template parameter : Network is the network in double, the reference.
+ All the connections have the same delay, so the threads update their ranges of neurons during a window of delayInSteps timeSteps without waiting for each other, then exchange the spikes of the whole window : one synchronisation per window instead of two per timeStep, with the same results.
+ The spikes of a timeStep are pushed by the sources into the buffers of their targets, or pulled by the targets from a bitset of the spikes (see SpikeGather) : the two modes give bit-identical buffers, the automatic mode chooses the faster one at each timeStep.
+ The connections can also be computed from their seed each time a source spikes, without storing them (see ProceduralConnectivity) : the network then has a fixed out-degree instead of a fixed in-degree.
+ Or they can be stored as differences of 16 bits between the sorted targets (see CompactConnectivity), half the memory of the indexes of 32 bits, with the same targets and the same spikes.
+ In a distributed simulation (see SpikeExchange), each process updates nbThreads_ consecutive ranges among the ranges of all the processes, only holds the connections that reach its neurons and receives the spikes of the other processes once per window : the spikes are the same as the ones of a single process with as many threads as all the ranges.
  */
 
-class Network{
+template<typename Precision>
+class BasicNetwork{
+    
+    public:
+    
+    typedef typename Precision::Input Input; //!< Type of the buffers of the neurons
     
     private:
 
@@ -28,12 +56,33 @@ class Network{
     unsigned long int nbNeurons_; //!< Total number of neurons that we want to simulate
     double Vext_; //!< Frequency at which Ce "artificial" neurons spike
     double Eta_; //!< Ratio Vext/Vthr
+    SpikeGather::Mode delivery_; //!< Mode of delivery of the spikes. Push at the construction
+    SpikeGather gather_; //!< The sources of each neuron and the bitsets of the spikes of the threads, for the pull delivery
+    SpikeExchange exchange_; //!< The processes of the simulation and the exchange of their spikes. A single process at the construction
+    bool proceduralConnectivity_; //!< True if the targets of a source are computed when it spikes instead of being stored (see ProceduralConnectivity). False at the construction
+    ProceduralConnectivity proceduralConnections_; //!< The connections computed from connectivitySeed_, if proceduralConnectivity_
+    bool compactConnectivity_; //!< True if the targets of the sources are stored as differences of 16 bits (see CompactConnectivity) instead of neuronConnections_. False at the construction
+    CompactConnectivity compactConnections_; //!< The connections encoded by createNetwork, if compactConnectivity_
+    unsigned int nbThreads_; //!< Number of threads that update the network, and number of ranges of neurons. Equals 1 at the construction
+    unsigned long int noiseSeed_; //!< Seed of the random generators of the background noise
+    unsigned long int connectivitySeed_; //!< Seed of the connections generated by createNetwork
+    std::string connectivityCache_; //!< Directory of the ConnectivityCache used by createNetwork, empty if the connections are always generated
+    ConnectivityTimings connectivityTimings_; //!< Durations of the generation (or of the reading) of the connections by createNetwork
     
-    std::mt19937 randomGen_; //!< Random generator, used for the Poisson distribution
-    std::poisson_distribution<> poissonDistr_; //!< The Poisson distribution used in the membrane equation, to simulate 1000 neurons spiking randomly
+    std::vector<BackgroundNoise> noises_; //!< Generators of the Poisson distribution used in the membrane equation, to simulate 1000 neurons spiking randomly, one per range of neurons
+    std::vector< std::vector<unsigned int> > noiseCounts_; //!< The draws of the background noise of one timeStep, one vector per range of neurons
 
     
-    std::ofstream spikes; //!< Stream to write the time and the ID of each neuron that has spiked (in the file ../result/spikes)
+    SpikeRecorder spikes; //!< Writes the time and the ID of each neuron that has spiked in a buffered binary file
+    std::string spikesFileName_; //!< Name of the binary file of the spikes, ../result/spikes.bin by default. Empty if the spikes are not written
+    unsigned long int nbRecordedSpikes_; //!< Number of spikes after StartStep, written or not
+    unsigned long int nbPulledSteps_; //!< Number of timeSteps whose spikes were pulled by the targets, counted by the thread 0
+    unsigned long int statisticsBinSteps_; //!< Number of timeSteps per bin of the histogram of statistics_, 0 if the statistics are not computed
+    bool statisticsStarted_; //!< True once statistics_ has been reset, at the first update
+    SpikeStatistics statistics_; //!< Histogram, spike counts, rate and CV of the spikes after StartStep
+
+    std::vector< std::vector< std::vector<uint32_t> > > spiking_; //!< spiking_[step][range] : indexes of the neurons of each range (of all the processes) that have spiked during each timeStep of the current and of the previous window
+    RunProfile profile_; //!< Time of each phase of the updates and number of spikes and synaptic events, measured with NEURON_PROFILING
 
     
     /*********************************************************************/
@@ -46,10 +95,6 @@ class Network{
      * @return Ce_
      */
     unsigned int getCe() const;
-    /**
-     * @return Eta_
-     */
-    double getEta() const;
 
     
     /*********************************************************************/
@@ -76,6 +121,87 @@ class Network{
      */
     void setVext(double const& newV);
     
+    /*********************************************************************/
+    
+    /**
+     * Creates the procedural connections of connectivitySeed_, with as many targets per source as the stored connections have sources per neuron
+     */
+    void createProceduralConnections();
+    /**
+     * @return true if the targets of the sources are in neuronConnections_, false if they are procedural or compact (the sources of the pull delivery can't be computed)
+     */
+    bool areConnectionsStored() const;
+    /**
+     * Creates one generator of the background noise per range of neurons of this process. The generator of the range r (among the ranges of all the processes) is seeded with noiseSeed_ and jumped to the stream r
+     */
+    void initRandomGens();
+    /**
+     * @return the index of the first range of this process, among the ranges of all the processes
+     */
+    size_t getFirstRange() const;
+    /**
+     * @param range is the index of a range of neurons, among the ranges of all the processes
+     * @return the index of its first neuron (the number of neurons if range is the number of ranges)
+     */
+    size_t getRangeBegin(size_t const& range) const;
+    
+    /**
+     * Send the spike of a neuron to its targets first to last-1, at the index Jidx of their buffer. The targets of a source are sorted, so that the ones in the range are found with a binary search
+     * @param source is the index of the neuron that has spiked
+     * @param first is the index of the first target that can receive the spike
+     * @param last is the index after the last target that can receive the spike
+     * @param Jidx is the index of the buffers where the spike is written
+     * @return the number of targets that have received the spike
+     */
+    size_t sendSpike(size_t const& source, size_t const& first, size_t const& last, size_t const& Jidx);
+    /**
+     * Like sendSpike, with the procedural connections : all the targets of the source are computed, the ones from first to last-1 receive the spike
+     * @param source is the index of the neuron that has spiked
+     * @param first is the index of the first target that can receive the spike
+     * @param last is the index after the last target that can receive the spike
+     * @param Jidx is the index of the buffers where the spike is written
+     * @return the number of targets that have received the spike
+     */
+    size_t sendProceduralSpike(size_t const& source, size_t const& first, size_t const& last, size_t const& Jidx);
+    /**
+     * Like sendSpike, with the compact connections : the targets of the source are decoded from the first one, the ones before first are skipped
+     * @param source is the index of the neuron that has spiked
+     * @param first is the index of the first target that can receive the spike
+     * @param last is the index after the last target that can receive the spike
+     * @param Jidx is the index of the buffers where the spike is written
+     * @return the number of targets that have received the spike
+     */
+    size_t sendCompactSpike(size_t const& source, size_t const& first, size_t const& last, size_t const& Jidx);
+    /**
+     * Pull delivery of the spikes of all the ranges during a timeStep : each neuron first to last-1 counts its sources that have spiked, and adds them to its buffer at the index Jidx, in the same order as sendSpike
+     * @param partition is the index of the range of neurons, and of the bitset of gather_
+     * @param first is the index of the first neuron of the range
+     * @param last is the index after the last neuron of the range
+     * @param spiking are the neurons that have spiked during the timeStep, one list per range
+     * @param Jidx is the index of the buffers where the spikes are written
+     * @return the number of spikes received by the range
+     */
+    size_t gatherSpikes(size_t const& partition, size_t const& first, size_t const& last, std::vector< std::vector<uint32_t> > const& spiking, size_t const& Jidx);
+    /**
+     * Delivers the spikes of all the ranges during a timeStep to the neurons first to last-1, pushed or pulled according to delivery_
+     * @param partition is the index of the range of neurons
+     * @param first is the index of the first neuron of the range
+     * @param last is the index after the last neuron of the range
+     * @param spiking are the neurons that have spiked during the timeStep, one list per range
+     * @param Jidx is the index of the buffers where the spikes are written
+     * @return the number of spikes received by the range
+     */
+    size_t deliverSpikes(size_t const& partition, size_t const& first, size_t const& last, std::vector< std::vector<uint32_t> > const& spiking, size_t const& Jidx);
+    
+    /**
+     * Update of the range of neurons "partition" of this process, executed by one thread from the global clock to StopStep, window after window (see getWindowSteps) : the range is updated alone during the timeSteps of a window, then the spikes of all the ranges during the window are delivered to the neurons of the range
+     * @param partition is the index of the range of neurons
+     * @param StartStep : beginning of the time interval for the graph
+     * @param StopStep : end of the time interval for the graph
+     * @param barrier synchronises the threads, once per window
+     */
+    void updatePartition(size_t const& partition, double const& StartStep, double const& StopStep, ThreadBarrier& barrier);
+    
 
     
     /*********************************************************************/
@@ -85,13 +211,18 @@ class Network{
     
     public :
     
-    std::vector< std::vector<size_t> > neuronConnections_; //!< Each neuron index has a vector containing the idx of its targets. Breaks the encapsulation a little bit but enables the tests to be run more easily
-    std::vector<Neuron*> neurons; //!< Contains all the neurons of the simulation. The getNbexcitatory first are excitatory, and the rest are inhibitory. Breaks the encapsulations but enables the tests to be run more easily
+    Connectivity neuronConnections_; //!< Each neuron index has a list containing the idx of its targets, in a frozen CSR format (32 bits targets). Breaks the encapsulation a little bit but enables the tests to be run more easily
+    BasicNeuronPopulation<Precision> neurons; //!< Contains the state of all the neurons of the simulation. The getNbexcitatory first are excitatory, and the rest are inhibitory. Breaks the encapsulations but enables the tests to be run more easily
     
     /**
-     * Creates nbNeurons_ neurons, decides which one are excitatory or inhibitory. Handles the connections between them. Load all the neurons in the attribute neurons.
+     * Creates nbNeurons_ neurons, decides which one are excitatory or inhibitory. Handles the connections between them, generated in parallel by a ConnectivityGenerator with connectivitySeed_, or read from the cache if one is set, or procedural. Load all the neurons in the attribute neurons.
      */
     void createNetwork();
+    /**
+     * Creates nbNeurons_ neurons like createNetwork, but with connections already generated (by another network with the same number of neurons, they don't depend on g and eta)
+     * @param connections are the targets of each neuron, empty with the procedural connections (computed from connectivitySeed_)
+     */
+    void createNetwork(Connectivity const& connections);
     
     /**
      * Method only usefull in the tests, to create and connect 2 neurons without background noise. The second neuron will be a target of the first one
@@ -102,6 +233,10 @@ class Network{
      * @return g_
      */
     double getG() const;
+    /**
+     * @return Eta_
+     */
+    double getEta() const;
     /**
      * Getter for the clock_
      * @return clock_
@@ -136,43 +271,238 @@ class Network{
      * @return Vext_
      */
     double getVext() const;
+    /**
+     * @return nbThreads_
+     */
+    unsigned int getNbThreads() const;
+    /**
+     * @return noiseSeed_
+     */
+    unsigned long int getNoiseSeed() const;
+    /**
+     * @return the number of ranges of neurons of all the processes, nbThreads_ in a single process
+     */
+    size_t getNbRanges() const;
+    /**
+     * @return the procedural connections, empty if the connections are stored
+     */
+    ProceduralConnectivity const& getProceduralConnections() const;
+    /**
+     * @return the compact connections, empty if the connections are not compact
+     */
+    CompactConnectivity const& getCompactConnections() const;
+    /**
+     * @return the processes of the simulation
+     */
+    SpikeExchange const& getExchange() const;
+    /**
+     * @return the number of spikes of the neurons of this process that happened after StartStep, written in the file or not
+     */
+    unsigned long int getNbRecordedSpikes() const;
+    /**
+     * @return connectivitySeed_
+     */
+    unsigned long int getConnectivitySeed() const;
+    /**
+     * @return the number of timeSteps of a window of the update : the delay in timeSteps (at least 1), since a spike can't reach any neuron before
+     */
+    size_t getWindowSteps() const;
+    /**
+     * @return the profile of all the updates of the network (see RunProfile)
+     */
+    RunProfile const& getProfile() const;
+    /**
+     * @return the durations of the generation (or of the reading) of the connections by createNetwork
+     */
+    ConnectivityTimings const& getConnectivityTimings() const;
+    /**
+     * @return the statistics of the spikes after StartStep, if they are computed. In a distributed simulation, only the spikes of the neurons of this process (see SpikeStatistics::reduce)
+     */
+    SpikeStatistics const& getStatistics() const;
+    /**
+     * @return the header of the files of the spikes and of the statistics, with the parameters of the network
+     */
+    SpikeFileHeader getSpikeFileHeader() const;
+    /**
+     * @return the physical parameters of the simulation (h, delay, Je, tau, epsilon)
+     */
+    PhysicsParameters const& getPhysics() const;
+    
+    /**
+     * Chooses how the spikes are delivered : pushed by the sources, pulled by the targets (the sources of each neuron are computed at the next update, which doubles the memory of the connections), or the faster of the two at each timeStep. The buffers are the same in all the modes
+     * @param mode is the mode of delivery
+     */
+    void setDelivery(SpikeGather::Mode const& mode);
+    /**
+     * @return delivery_
+     */
+    SpikeGather::Mode getDelivery() const;
+    /**
+     * @return the sources of each neuron and the choice of the automatic mode, to tune it
+     */
+    SpikeGather& getGather();
+    /**
+     * @return the number of timeSteps of all the updates whose spikes were pulled by the targets instead of being pushed by the sources
+     */
+    unsigned long int getNbPulledSteps() const;
+    /**
+     * Chooses between the buffers of spikes and the spike counters of the neurons (see NeuronPopulation::setSpikeCounters) : a spike is then an increment of the counter of its type, weighted by 1 or -g when the neurons read it.
+     * Has to be called before createNetwork. Each neuron can receive at most 65535 spikes of a type per timeStep (in-degree and background noise)
+     * @param b is true for the spike counters
+     */
+    void setSpikeCounters(bool const& b);
+    /**
+     * @return true if the neurons count the spikes instead of summing them in buffers
+     */
+    bool getSpikeCounters() const;
+    /**
+     * Setter for nbThreads_, the random generators are created again
+     * @param nb is the number of threads that will update the network
+     */
+    void setNbThreads(unsigned int const& nb);
+    /**
+     * Makes the network one process of a distributed simulation : createNetwork only generates the connections that reach the neurons of the process, and its file of spikes only contains their spikes. Has to be called before createNetwork, the random generators are created again
+     * @param exchange connects the process to the other ones
+     */
+    void setExchange(SpikeExchange const& exchange);
+    /**
+     * Chooses if the spikes are written by a dedicated I/O thread (see SpikeRecorder). Has to be called before the first update
+     * @param b is true for the asynchronous output (false by default)
+     */
+    void setAsynchronousOutput(bool const& b);
+    /**
+     * Setter for the name of the binary file of the spikes. Has to be called before the first update
+     * @param fileName is the name of the file, empty if the spikes should only be counted
+     */
+    void setSpikesFileName(std::string const& fileName);
+    /**
+     * Computes the statistics of the spikes during the simulation (see SpikeStatistics). Has to be called before the first update
+     * @param binSteps is the number of timeSteps per bin of the histogram of the population
+     */
+    void enableStatistics(unsigned long int const& binSteps);
+    /**
+     * Setter for connectivitySeed_, has to be called before createNetwork
+     * @param seed is the new seed of the connections
+     */
+    void setConnectivitySeed(unsigned long int const& seed);
+    /**
+     * Chooses between the connections generated and stored by createNetwork and the procedural connections (see ProceduralConnectivity), computed from connectivitySeed_ each time a source spikes : nothing is stored, but the pull delivery is impossible and each neuron has a fixed number of targets instead of a fixed number of sources.
+     * Has to be called before createNetwork
+     * @param b is true for the procedural connections
+     */
+    void setProceduralConnectivity(bool const& b);
+    /**
+     * @return proceduralConnectivity_
+     */
+    bool getProceduralConnectivity() const;
+    /**
+     * Chooses between the targets stored as indexes of 32 bits and the compact connections (see CompactConnectivity), stored as differences of 16 bits : the same connections in half the memory, but the pull delivery is impossible.
+     * Has to be called before createNetwork, not with the procedural connections
+     * @param b is true for the compact connections
+     */
+    void setCompactConnectivity(bool const& b);
+    /**
+     * @return compactConnectivity_
+     */
+    bool getCompactConnectivity() const;
+    /**
+     * Chooses a directory where createNetwork keeps the connections it generates, and reads them back in the next runs with the same neurons, epsilon and seed (see ConnectivityCache)
+     * @param directory is the directory of the cache, empty to always generate the connections
+     */
+    void setConnectivityCache(std::string const& directory);
+    /**
+     * Setter for noiseSeed_, the random generators are created again
+     * @param seed is the new seed of the background noise
+     */
+    void setNoiseSeed(unsigned long int const& seed);
     
 
     
     /*********************************************************************/
     
     /**
-     * Constructor of a network
+     * Constructor of a network with random seeds : each run has other connections and another background noise
+     * @param backgroundNoise : true if you want backgroundNoise
+     * @param g : ratio Ji/Je
+     * @param Eta : ratio Vext/Vthr
+     * @param nbNeurons is the number of neurons we want to simulate
+     * @param physics are the physical parameters (the ones of Utility/Constants.h by default)
+     */
+    BasicNetwork(bool const& backgroundNoise, double const& g, double const& Eta, double const& nbNeurons, PhysicsParameters const& physics = PhysicsParameters());
+    /**
+     * Constructor of a reproducible network : the same seeds, number of threads and parameters always give the same spikes
      * @param backgroundNoise : true if you want backgroundNoise
      * @param g : ratio Ji/Je
      * @param Eta : ratio Vext/Vthr
      * @param nbNeurons is the number of neurons we want to simulate
+     * @param connectivitySeed is the seed of the connections generated by createNetwork
+     * @param noiseSeed is the seed of the background noise
+     * @param physics are the physical parameters (the ones of Utility/Constants.h by default)
      */
-    Network(bool const& backgroundNoise, double const& g, double const& Eta, double const& nbNeurons);
+    BasicNetwork(bool const& backgroundNoise, double const& g, double const& Eta, double const& nbNeurons, unsigned long int const& connectivitySeed, unsigned long int const& noiseSeed, PhysicsParameters const& physics = PhysicsParameters());
     
     /**
-     * Destructor of a network, have to delete all the pointers it contained
+     * Destructor of a network, writes the spikes left in the buffer and closes the file of the spikes
      */
-    ~Network();
+    ~BasicNetwork();
     
     /*********************************************************************/
     
+    /**
+     * Send the spike of a neuron to all its targets : adds 1 (excitatory source) or -g (inhibitory source) in the buffer of each target, or 1 in the counter of the type of the source, at the index jIdxToWrite_
+     * @param source is the index of the neuron that has spiked
+     */
+    void sendSpike(size_t const& source);
+
     /**
      * Increase circularly the index from jToAdd_
      */
     void updateJIndex();
     
     /**
-     * Update the network: call the method update of each neurons of the simulation
+     * Update the network: call the method update of each neurons of the simulation, with nbThreads_ threads. The file of the spikes is opened at the first update, with the parameters of the network in its header
      * @param StartStep : beginning of the time interval for the graph
      * @param StopStep : end of the time interval for the graph
      */
     void updateNetwork(double const& StartStep, double const& StopStep);
     
+    /**
+     * Saves the state of the simulation in a checkpoint file, that can be memory-mapped (see CheckpointWriter). The statistics and the file of the spikes are not saved.
+     * The file is written under a temporary name then renamed, so that it can be the checkpoint the network was restored from
+     * @param fileName is the name of the file
+     * @throw std::string if the file can't be written, or if the simulation is distributed
+     */
+    void saveCheckpoint(std::string const& fileName) const;
+    /**
+     * Replaces the state of the network by the one of a checkpoint : parameters, number of threads, seed, clock, neurons, connections (used in place in the memory-mapped file) and random generators.
+     * The network continues bit-identically to the saved one. Calling setNoiseSeed after the restoration starts a new branch of the noise from the same state
+     * @param fileName is the name of the file
+     * @throw std::string if the file can't be read or is not a valid checkpoint, or if the simulation is distributed
+     */
+    void restoreCheckpoint(std::string const& fileName);
+
+    /**
+     * Writes the spikes left in memory and closes the file of the spikes, at the end of the run
+     */
+    void closeSpikesFile();
+    
+    /**
+     * Prints the statistics of the output of the spikes, to see if the disk kept up with the simulation. Complete once the file is closed
+     * @param out is the stream where the statistics are printed
+     */
+    void printSpikesStatistics(std::ostream& out) const;
+    /**
+     * Prints the memory used by the neurons and their buffers, by the connections (stored, compact or procedural), by the sources of the pull delivery and by the lists of the spikes of the threads
+     * @param out is the stream where the memory is printed
+     */
+    void printMemoryUsage(std::ostream& out) const;
+    
     /**
      * Increases the global clock_ of one TimeStep h
      */
     void updateTime();
 };
 
+typedef BasicNetwork<DoublePrecision> Network; //!< The network of the reference precision
+
 #endif /* network_hpp */
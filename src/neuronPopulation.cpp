@@ -0,0 +1,275 @@
+#include "neuronPopulation.hpp"
+
+template<typename Precision>
+BasicNeuronPopulation<Precision>::BasicNeuronPopulation()
+: spikeCounters_(false), inhibitoryWeight_(0)
+{}
+
+template<typename Precision>
+void BasicNeuronPopulation<Precision>::setPhysics(PhysicsParameters const& physics){
+
+    physics_ = physics;
+}
+
+template<typename Precision>
+PhysicsParameters const& BasicNeuronPopulation<Precision>::getPhysics() const{
+
+    return physics_;
+}
+
+template<typename Precision>
+void BasicNeuronPopulation<Precision>::setSpikeCounters(bool const& b, double const& g){
+
+    spikeCounters_ = b;
+    inhibitoryWeight_ = g;
+}
+
+template<typename Precision>
+bool BasicNeuronPopulation<Precision>::getSpikeCounters() const{
+
+    return spikeCounters_;
+}
+
+template<typename Precision>
+void BasicNeuronPopulation<Precision>::resize(size_t const& nbNeurons, size_t const& nbExcitatory){
+
+    assert(nbExcitatory <= nbNeurons);
+
+    //Ensures that no neuron of a previous population is kept
+    I_.assign(nbNeurons, 0);
+    isExcitatory_.assign(nbNeurons, 0);
+    membranePotential_.assign(nbNeurons, 0);
+    //Same initial value as Neuron::timeSpike_
+    timeSpike_.assign(nbNeurons, 1000);
+    //All the connections have the same delay, only the buffers of the mode are allocated
+    jToAdd_.resize(spikeCounters_ ? 0 : nbNeurons, physics_.getDelayInSteps());
+    excitatoryCounts_.resize(spikeCounters_ ? nbNeurons : 0, physics_.getDelayInSteps());
+    inhibitoryCounts_.resize(spikeCounters_ ? nbNeurons : 0, physics_.getDelayInSteps());
+
+    //The nbExcitatory first neurons are excitatory
+    for(size_t i(0) ; i < nbExcitatory ; ++i)
+        isExcitatory_[i] = 1;
+}
+
+template<typename Precision>
+size_t BasicNeuronPopulation<Precision>::size() const{
+
+    return membranePotential_.size();
+}
+
+template<typename Precision>
+bool BasicNeuronPopulation<Precision>::empty() const{
+
+    return membranePotential_.empty();
+}
+
+/*********************************************************************/
+
+template<typename Precision>
+bool BasicNeuronPopulation<Precision>::getIsExcitatory(size_t const& idx) const{
+
+    return isExcitatory_[idx];
+}
+
+template<typename Precision>
+double BasicNeuronPopulation<Precision>::getMembranePotential(size_t const& idx) const{
+
+    return membranePotential_[idx];
+}
+
+template<typename Precision>
+void BasicNeuronPopulation<Precision>::setI(size_t const& idx, double const& I){
+
+    I_[idx] = I;
+}
+
+template<typename Precision>
+void BasicNeuronPopulation<Precision>::setIsExcitatory(size_t const& idx, bool const& b){
+
+    isExcitatory_[idx] = b;
+}
+
+template<typename Precision>
+size_t BasicNeuronPopulation<Precision>::getMemoryUsage() const{
+
+    size_t neurons((I_.capacity() + membranePotential_.capacity() + timeSpike_.capacity())*sizeof(State) + isExcitatory_.capacity()*sizeof(unsigned char));
+    size_t buffers(jToAdd_.getNbNeurons()*jToAdd_.getNbSlots()*sizeof(Input) + (excitatoryCounts_.getNbNeurons()*excitatoryCounts_.getNbSlots() + inhibitoryCounts_.getNbNeurons()*inhibitoryCounts_.getNbSlots())*sizeof(uint16_t));
+    return neurons + buffers;
+}
+
+template<typename Precision>
+MembraneKernel const& BasicNeuronPopulation<Precision>::getKernel() const{
+
+    return kernel_;
+}
+
+template<typename Precision>
+void BasicNeuronPopulation<Precision>::setKernel(MembraneKernel::Instructions const& instructions){
+
+    kernel_ = MembraneKernel(instructions);
+}
+
+template<typename Precision>
+typename BasicNeuronPopulation<Precision>::Input& BasicNeuronPopulation<Precision>::jToAdd(size_t const& idx, size_t const& Jidx){
+
+    assert(!spikeCounters_);
+    return jToAdd_.getSlot(Jidx)[idx];
+}
+
+template<typename Precision>
+typename BasicNeuronPopulation<Precision>::Input* BasicNeuronPopulation<Precision>::getSlot(size_t const& Jidx){
+
+    assert(!spikeCounters_);
+    return jToAdd_.getSlot(Jidx);
+}
+
+template<typename Precision>
+uint16_t* BasicNeuronPopulation<Precision>::getExcitatoryCounts(size_t const& Jidx){
+
+    assert(spikeCounters_);
+    return excitatoryCounts_.getSlot(Jidx);
+}
+
+template<typename Precision>
+uint16_t* BasicNeuronPopulation<Precision>::getInhibitoryCounts(size_t const& Jidx){
+
+    assert(spikeCounters_);
+    return inhibitoryCounts_.getSlot(Jidx);
+}
+
+template<typename Precision>
+size_t BasicNeuronPopulation<Precision>::getNbSlots() const{
+
+    return spikeCounters_ ? excitatoryCounts_.getNbSlots() : jToAdd_.getNbSlots();
+}
+
+template<typename Precision>
+typename BasicNeuronPopulation<Precision>::State BasicNeuronPopulation<Precision>::getInput(size_t const& idx, size_t const& Jidx) const{
+
+    if(spikeCounters_)
+        return State(excitatoryCounts_.getSlot(Jidx)[idx]) - State(inhibitoryWeight_)*State(inhibitoryCounts_.getSlot(Jidx)[idx]);
+    return State(jToAdd_.getSlot(Jidx)[idx]);
+}
+
+template<typename Precision>
+void BasicNeuronPopulation<Precision>::clearSlot(size_t const& Jidx, size_t const& first, size_t const& last){
+
+    if(spikeCounters_){
+        excitatoryCounts_.clear(Jidx, first, last);
+        inhibitoryCounts_.clear(Jidx, first, last);
+    }
+    else
+        jToAdd_.clear(Jidx, first, last);
+}
+
+template<typename Precision>
+void BasicNeuronPopulation<Precision>::save(CheckpointWriter& writer) const{
+
+    //The arrays can only be restored in the same precision
+    writer.write<uint8_t>(sizeof(State));
+    writer.write<uint8_t>(sizeof(Input));
+
+    writer.writeArray(I_.data(), I_.size());
+    writer.writeArray(isExcitatory_.data(), isExcitatory_.size());
+    writer.writeArray(membranePotential_.data(), membranePotential_.size());
+    writer.writeArray(timeSpike_.data(), timeSpike_.size());
+    writer.write<uint8_t>(spikeCounters_);
+    writer.write(inhibitoryWeight_);
+    if(spikeCounters_){
+        excitatoryCounts_.save(writer);
+        inhibitoryCounts_.save(writer);
+    }
+    else
+        jToAdd_.save(writer);
+}
+
+template<typename Precision>
+void BasicNeuronPopulation<Precision>::restore(CheckpointReader& reader){
+
+    uint8_t stateSize(0), inputSize(0);
+    reader.read(stateSize);
+    reader.read(inputSize);
+    if(stateSize != sizeof(State) or inputSize != sizeof(Input))
+        reader.fail("was saved with another precision than " + Precision::getName());
+
+    reader.readArray(I_);
+    reader.readArray(isExcitatory_);
+    reader.readArray(membranePotential_);
+    reader.readArray(timeSpike_);
+
+    //The mode of the buffers is the one of the checkpoint, the buffers of the other mode are freed
+    uint8_t spikeCounters(0);
+    reader.read(spikeCounters);
+    reader.read(inhibitoryWeight_);
+    spikeCounters_ = spikeCounters;
+    jToAdd_.resize(0, physics_.getDelayInSteps());
+    excitatoryCounts_.resize(0, physics_.getDelayInSteps());
+    inhibitoryCounts_.resize(0, physics_.getDelayInSteps());
+    if(spikeCounters_){
+        excitatoryCounts_.restore(reader);
+        inhibitoryCounts_.restore(reader);
+    }
+    else
+        jToAdd_.restore(reader);
+
+    if(I_.size() != size() or isExcitatory_.size() != size() or timeSpike_.size() != size())
+        reader.fail("has arrays of neurons of different sizes");
+    if(spikeCounters_ ? (excitatoryCounts_.getNbNeurons() != size() or inhibitoryCounts_.getNbNeurons() != size()) : jToAdd_.getNbNeurons() != size())
+        reader.fail("has arrays of neurons of different sizes");
+    if(getNbSlots() != physics_.getDelayInSteps()+1 or (spikeCounters_ and inhibitoryCounts_.getNbSlots() != getNbSlots()))
+        reader.fail("has a delay buffer that doesn't match the delay");
+}
+
+/*********************************************************************/
+
+template<typename Precision>
+bool BasicNeuronPopulation<Precision>::update(size_t const& idx, size_t const& Jidx, int const& time){
+
+    // Contains the number of spikes the neuron should add to its membrane potential at the current time
+    State nbSpikes(getInput(idx, Jidx));
+    // Empty the corresponding case of the buffer after reading it
+    clearSlot(Jidx, idx, idx+1);
+
+    // The neuron is in a refractory state, nothing happens
+    if (std::abs(time-timeSpike_[idx]) < physics_.getRefractoryTimeStep())
+        return false;
+
+    // If the membrane potential is bigger than the threshold, the neuron spikes and is reset
+    if(membranePotential_[idx] >= threshold){
+        membranePotential_[idx] = Vreset;
+        timeSpike_[idx] = time;
+        return true;
+    }
+
+    // Same equation as Neuron::MembraneEquation
+    membranePotential_[idx] = State(physics_.getScalarCste1())*membranePotential_[idx] + I_[idx]*State(physics_.getScalarCste2()) + nbSpikes*State(physics_.getJe());
+
+    return false;
+}
+
+template<typename Precision>
+void BasicNeuronPopulation<Precision>::updateAll(size_t const& Jidx, int const& time, std::vector<uint32_t>& spiking){
+
+    updateRange(0, size(), Jidx, time, spiking);
+}
+
+template<typename Precision>
+void BasicNeuronPopulation<Precision>::updateRange(size_t const& first, size_t const& last, size_t const& Jidx, int const& time, std::vector<uint32_t>& spiking){
+
+    assert(first <= last and last <= size());
+    spiking.clear();
+
+    //The numbers of spikes of the range are already contiguous in the slot read during this timeStep
+    if(spikeCounters_)
+        kernel_.integrate(membranePotential_.data() + first, timeSpike_.data() + first, I_.data() + first, excitatoryCounts_.getSlot(Jidx) + first, inhibitoryCounts_.getSlot(Jidx) + first, inhibitoryWeight_, last - first, time, first, physics_, spiking);
+    else
+        kernel_.integrate(membranePotential_.data() + first, timeSpike_.data() + first, I_.data() + first, jToAdd_.getSlot(Jidx) + first, last - first, time, first, physics_, spiking);
+
+    //Empty the range of the slot after reading it
+    clearSlot(Jidx, first, last);
+}
+
+//The populations of the precisions of PrecisionPolicy
+template class BasicNeuronPopulation<DoublePrecision>;
+template class BasicNeuronPopulation<SinglePrecision>;
+template class BasicNeuronPopulation<MixedPrecision>;
@@ -0,0 +1,233 @@
+#ifndef NEURON_POPULATION_H
+#define NEURON_POPULATION_H
+
+#include <vector>
+#include <math.h>
+#include <cassert>
+#include "../Utility/Constants.h"
+#include "membraneKernel.hpp"
+#include "delayRingBuffer.hpp"
+#include "physicsParameters.hpp"
+#include "precision.hpp"
+
+
+//!  Class BasicNeuronPopulation
+/*!
+ This class stores the state of all the neurons of a network in a structure-of-arrays layout : instead of one heap allocated Neuron per index, every attribute (membrane potential, time of the last spike, external current, type) lives in its own contiguous array indexed by the id of the neuron.
+ The buffers jToAdd_ of all the neurons form a single DelayRingBuffer laid out as [slot][neuron], with delayInSteps+1 slots : during a timeStep all the neurons read the same slot, which is one contiguous array given directly to the kernel and emptied with a memset.
+
+ The dynamics are exactly the ones of the class Neuron, so that a network of NeuronPopulation behaves like a network of Neuron, but the update of all the neurons is a linear sweep over these arrays, done by a vectorized MembraneKernel.
+
+ The types of the arrays are given by a PrecisionPolicy : NeuronPopulation is the population in double, the reference. The getters and setters always use double.
+
+ When all the synapses of a type have the same weight (1 for the excitatory ones, -g for the inhibitory ones), the buffers can be replaced by spike counters (see setSpikeCounters) : two ring buffers of uint16_t count the excitatory and the inhibitory spikes received by each neuron, and the input excitatory - g*inhibitory is only computed when the kernel reads them.
+ The counters take 4 bytes per neuron and slot instead of 8 for a buffer in double, and the delivery of a spike is an integer increment. The input is the same as the one of a buffer as long as its sum is exact (g with few bits, like 5), so the dynamics don't change.
+ */
+
+template<typename Precision>
+class BasicNeuronPopulation{
+
+    public:
+
+    typedef typename Precision::State State; //!< Type of the membrane potentials, times of the last spike and currents
+    typedef typename Precision::Input Input; //!< Type of the buffers
+
+    private:
+
+    std::vector<State> I_; //!< The external current of each neuron
+    std::vector<unsigned char> isExcitatory_; //!< 1 if the neuron is excitatory, 0 if it is inhibitory (not a vector<bool>, to keep one byte per neuron)
+    std::vector<State> membranePotential_; //!< The membrane potential of each neuron in [mV]
+    std::vector<State> timeSpike_; //!< Time at which each neuron has spiked for the last time
+    BasicDelayRingBuffer<Input> jToAdd_; //!< The buffers of all the neurons, one slot per index of Neuron::jToAdd_ (empty with spike counters)
+    bool spikeCounters_; //!< True if the spikes are counted in excitatoryCounts_ and inhibitoryCounts_ instead of jToAdd_
+    double inhibitoryWeight_; //!< With spike counters : g, the weight of an inhibitory spike is -g
+    BasicDelayRingBuffer<uint16_t> excitatoryCounts_; //!< With spike counters : the numbers of excitatory spikes (and of spikes of the background noise) of all the neurons, same slots as jToAdd_
+    BasicDelayRingBuffer<uint16_t> inhibitoryCounts_; //!< With spike counters : the numbers of inhibitory spikes of all the neurons, same slots as jToAdd_
+    PhysicsParameters physics_; //!< The constants of the membrane equation and the delay (the ones of Utility/Constants.h by default)
+    MembraneKernel kernel_; //!< Integrates the membrane potentials of a range of neurons (best instruction set of the processor by default)
+
+
+    /*********************************************************************/
+
+    /**
+     * @param idx is the index of the neuron
+     * @param Jidx is the index of the slot
+     * @return the input of the neuron in the slot : its case of jToAdd_, or its counters weighted by 1 and -g
+     */
+    State getInput(size_t const& idx, size_t const& Jidx) const;
+    /**
+     * Empties a range of a slot of the buffers, or of the counters
+     * @param Jidx is the index of the slot
+     * @param first is the index of the first neuron
+     * @param last is the index after the last neuron
+     */
+    void clearSlot(size_t const& Jidx, size_t const& first, size_t const& last);
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Constructor of an empty population, use resize to create the neurons
+     */
+    BasicNeuronPopulation();
+
+    /**
+     * Chooses the physical parameters of the neurons, before resize (the number of slots of the buffers depends on the delay)
+     * @param physics are the new parameters
+     */
+    void setPhysics(PhysicsParameters const& physics);
+    /**
+     * @return physics_
+     */
+    PhysicsParameters const& getPhysics() const;
+
+    /**
+     * Chooses between the buffers of spikes and the spike counters, before resize
+     * @param b is true to count the excitatory and the inhibitory spikes in uint16_t (at most 65535 spikes of a type per neuron and timeStep)
+     * @param g is the weight of an inhibitory spike is -g, used with spike counters
+     */
+    void setSpikeCounters(bool const& b, double const& g);
+    /**
+     * @return true if the spikes are counted instead of summed in buffers
+     */
+    bool getSpikeCounters() const;
+
+    /**
+     * Creates nbNeurons neurons at rest. The nbExcitatory first are excitatory, the rest are inhibitory
+     * @param nbNeurons is the total number of neurons
+     * @param nbExcitatory is the number of excitatory neurons
+     */
+    void resize(size_t const& nbNeurons, size_t const& nbExcitatory);
+
+    /**
+     * @return the number of neurons of the population
+     */
+    size_t size() const;
+    /**
+     * @return true if the population doesn't contain any neuron
+     */
+    bool empty() const;
+    /**
+     * @return the number of bytes used by the arrays of the neurons, their buffers or counters
+     */
+    size_t getMemoryUsage() const;
+
+
+    /*********************************************************************/
+
+    /**
+     * @param idx is the index of the neuron
+     * @return isExcitatory_ of the neuron idx
+     */
+    bool getIsExcitatory(size_t const& idx) const;
+    /**
+     * @param idx is the index of the neuron
+     * @return membranePotential_ of the neuron idx
+     */
+    double getMembranePotential(size_t const& idx) const;
+
+    /**
+     * Setter for the current I_ of one neuron
+     * @param idx is the index of the neuron
+     * @param I is the new I_
+     */
+    void setI(size_t const& idx, double const& I);
+    /**
+     * Setter for isExcitatory_ of one neuron
+     * @param idx is the index of the neuron
+     * @param b is a boolean for the new state of isExcitatory_
+     */
+    void setIsExcitatory(size_t const& idx, bool const& b);
+
+    /**
+     * @return the kernel that integrates the membrane potentials
+     */
+    MembraneKernel const& getKernel() const;
+    /**
+     * Chooses the instruction set of the kernel
+     * @param instructions is an instruction set available on the processor
+     */
+    void setKernel(MembraneKernel::Instructions const& instructions);
+
+    /**
+     * Access to one case of the buffer of a neuron, without spike counters
+     * @param idx is the index of the neuron
+     * @param Jidx is the index of the case in the buffer of the neuron
+     * @return a reference on the case, to read or to add spikes to it
+     */
+    Input& jToAdd(size_t const& idx, size_t const& Jidx);
+    /**
+     * Access to one slot of the buffers, to add spikes to many neurons without computing the address of each case
+     * @param Jidx is the index of the slot
+     * @return a pointer on the case of the neuron 0, the case of the neuron idx is at +idx
+     */
+    Input* getSlot(size_t const& Jidx);
+    /**
+     * Access to one slot of the counters of the excitatory spikes, with spike counters
+     * @param Jidx is the index of the slot
+     * @return a pointer on the counter of the neuron 0, the counter of the neuron idx is at +idx
+     */
+    uint16_t* getExcitatoryCounts(size_t const& Jidx);
+    /**
+     * Access to one slot of the counters of the inhibitory spikes, with spike counters
+     * @param Jidx is the index of the slot
+     * @return a pointer on the counter of the neuron 0, the counter of the neuron idx is at +idx
+     */
+    uint16_t* getInhibitoryCounts(size_t const& Jidx);
+    /**
+     * @return the number of slots of the buffers (delay in timeSteps + 1)
+     */
+    size_t getNbSlots() const;
+
+
+    /**
+     * Writes the state of all the neurons (sizes of the types of the precision, currents, types, membrane potentials, times of the last spike and buffers or counters) in a checkpoint
+     * @param writer is the checkpoint
+     */
+    void save(CheckpointWriter& writer) const;
+    /**
+     * Reads the state of all the neurons from a checkpoint, with its mode of the buffers (spike counters or not). The physical parameters have to be set before
+     * @param reader is the checkpoint
+     * @throw std::string if the checkpoint has another precision, the arrays don't have the same size or the delay doesn't match
+     */
+    void restore(CheckpointReader& reader);
+
+
+    /*********************************************************************/
+
+    /**
+     * Update one neuron of one timeStep, exactly like Neuron::update
+     * @param idx is the index of the neuron
+     * @param Jidx is the index at which the neuron should read its buffer
+     * @param time is the global time
+     * @return true if the neuron has spiked
+     */
+    bool update(size_t const& idx, size_t const& Jidx, int const& time=0);
+
+    /**
+     * Update all the neurons of the population of one timeStep, in the order of their index
+     * @param Jidx is the index at which the neurons should read their buffer
+     * @param time is the global time
+     * @param spiking is filled with the indexes of the neurons that have spiked (in increasing order)
+     */
+    void updateAll(size_t const& Jidx, int const& time, std::vector<uint32_t>& spiking);
+
+    /**
+     * Update the neurons first to last-1 of one timeStep, with the kernel. Two ranges that don't overlap can be updated at the same time by two threads
+     * @param first is the index of the first neuron to update
+     * @param last is the index after the last neuron to update
+     * @param Jidx is the index at which the neurons should read their buffer
+     * @param time is the global time
+     * @param spiking is filled with the indexes of the neurons that have spiked (in increasing order)
+     */
+    void updateRange(size_t const& first, size_t const& last, size_t const& Jidx, int const& time, std::vector<uint32_t>& spiking);
+
+};
+
+typedef BasicNeuronPopulation<DoublePrecision> NeuronPopulation; //!< The population of the reference precision
+
+#endif
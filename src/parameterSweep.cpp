@@ -0,0 +1,159 @@
+#include "parameterSweep.hpp"
+#include "network.hpp"
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <fstream>
+#include <thread>
+#include <algorithm>
+
+ParameterSweep::ParameterSweep(SimulationConfig const& config)
+: config_(config), gValues_(config.getSweepG()), etaValues_(config.getSweepEta()), results_(gValues_.size()*etaValues_.size()), connectivitySeed_(0), nextPoint_(0)
+{
+    for(size_t i(0) ; i < getNbPoints() ; ++i){
+        results_[i].g = gValues_[i/etaValues_.size()];
+        results_[i].eta = etaValues_[i%etaValues_.size()];
+    }
+}
+
+size_t ParameterSweep::getNbPoints() const{
+
+    return results_.size();
+}
+
+std::vector<SweepResult> const& ParameterSweep::getResults() const{
+
+    return results_;
+}
+
+std::string ParameterSweep::getPointFileName(std::string const& fileName, double const& g, double const& eta){
+
+    //The extension of the file (after the last dot of its name, not of its directory) is kept at the end
+    std::string base(fileName), extension;
+    size_t dot(base.find_last_of('.')), slash(base.find_last_of('/'));
+    if(dot != std::string::npos and (slash == std::string::npos or dot > slash+1)){
+        extension = base.substr(dot);
+        base.erase(dot);
+    }
+
+    std::ostringstream name;
+    name << base << "_g" << g << "_eta" << eta << extension;
+    return name.str();
+}
+
+/*********************************************************************/
+
+void ParameterSweep::run(std::ostream& log){
+
+    std::chrono::steady_clock::time_point begin(std::chrono::steady_clock::now());
+
+    //The connections are generated by a network without background noise, g and eta don't matter
+    Network builder(false, gValues_.front(), etaValues_.front(), config_.getNbNeurons(), config_.getPhysics());
+    if(config_.hasConnectivitySeed())
+        builder.setConnectivitySeed(config_.getConnectivitySeed());
+    builder.setConnectivityCache(config_.getConnectivityCache());
+    //The procedural connections are not stored : the points compute them again from the same seed
+    builder.setProceduralConnectivity(config_.getProceduralConnectivity());
+    builder.createNetwork();
+    Connectivity connections(builder.neuronConnections_);
+    connectivitySeed_ = builder.getConnectivitySeed();
+
+    if(builder.getProceduralConnectivity())
+        log << "Procedural connections : " << builder.getProceduralConnections().getNbSynapses() << " synapses, not stored" << std::endl;
+    else
+        log << "Connections " << (builder.getConnectivityTimings().loaded ? "read from the cache" : "generated once") << " : " << connections.getNbSynapses() << " synapses in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count() << " s" << std::endl;
+
+    //The same seed for all the points, random if it is not given
+    unsigned long int noiseSeed(config_.getSeed());
+    if(!config_.hasSeed()){
+        std::random_device rd;
+        noiseSeed = rd();
+    }
+
+    //The points are distributed between the threads as they finish
+    nextPoint_ = 0;
+    size_t nbJobs(std::min<size_t>(config_.getSweepJobs(), getNbPoints()));
+    std::vector<std::thread> threads;
+    for(size_t job(1) ; job < nbJobs ; ++job)
+        threads.push_back(std::thread(&ParameterSweep::runPoints, this, std::cref(connections), noiseSeed, std::ref(log)));
+
+    runPoints(connections, noiseSeed, log);
+
+    for(auto& thread : threads)
+        thread.join();
+}
+
+void ParameterSweep::runPoints(Connectivity const& connections, unsigned long int const& noiseSeed, std::ostream& log){
+
+    for(size_t index(nextPoint_++) ; index < getNbPoints() ; index = nextPoint_++){
+        runPoint(index, connections, noiseSeed);
+
+        SweepResult const& result(results_[index]);
+        std::lock_guard<std::mutex> lock(logMutex_);
+        log << "Point " << index+1 << "/" << getNbPoints() << " : g = " << result.g << ", eta = " << result.eta << ", " << result.rate << " Hz (" << result.time << " s)" << std::endl;
+    }
+}
+
+void ParameterSweep::runPoint(size_t const& index, Connectivity const& connections, unsigned long int const& noiseSeed){
+
+    //All the points in the precision of the config
+    if(config_.getPrecision() == SinglePrecision::getName())
+        simulatePoint<SinglePrecision>(index, connections, noiseSeed);
+    else if(config_.getPrecision() == MixedPrecision::getName())
+        simulatePoint<MixedPrecision>(index, connections, noiseSeed);
+    else
+        simulatePoint<DoublePrecision>(index, connections, noiseSeed);
+}
+
+template<typename Precision>
+void ParameterSweep::simulatePoint(size_t const& index, Connectivity const& connections, unsigned long int const& noiseSeed){
+
+    std::chrono::steady_clock::time_point begin(std::chrono::steady_clock::now());
+    SweepResult& result(results_[index]);
+    PhysicsParameters physics(config_.getPhysics());
+
+    BasicNetwork<Precision> net(true, result.g, result.eta, config_.getNbNeurons(), connectivitySeed_, noiseSeed, physics);
+    net.setNbThreads(config_.getNbThreads());
+    net.setSpikeCounters(config_.getSpikeCounters());
+    net.setProceduralConnectivity(config_.getProceduralConnectivity());
+    net.setDelivery(config_.getDelivery());
+    result.spikesFileName = config_.getSweepSpikes() ? getPointFileName(config_.getOutput(), result.g, result.eta) : "";
+    net.setSpikesFileName(result.spikesFileName);
+    net.enableStatistics(config_.getBinSteps());
+    net.createNetwork(connections);
+
+    //Change ms into timesteps, like the main program
+    double Stopstep = static_cast<unsigned long>(ceil(config_.getStop()/physics.getH()));
+    double Startstep = static_cast<unsigned long>(ceil(config_.getStart()/physics.getH()));
+    net.updateNetwork(Startstep, Stopstep);
+    net.closeSpikesFile();
+
+    result.noiseSeed = noiseSeed;
+    result.connectivitySeed = connectivitySeed_;
+    result.nbSpikes = net.getNbRecordedSpikes();
+    //The spikes are counted after Startstep, until Stopstep
+    result.rate = result.nbSpikes/(config_.getNbNeurons()*std::max(Stopstep - Startstep - 1, 1.0)*physics.getH()*1e-3);
+    result.cv = net.getStatistics().getMeanCV();
+    result.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    if(!config_.getStatistics().empty())
+        net.getStatistics().write(getPointFileName(config_.getStatistics(), result.g, result.eta), net.getSpikeFileHeader());
+}
+
+/*********************************************************************/
+
+void ParameterSweep::writeSummary(std::ostream& out) const{
+
+    out << "# g eta seed connectivity-seed spikes rate[Hz] cv time[s]" << std::endl;
+    for(auto const& result : results_)
+        out << result.g << " " << result.eta << " " << result.noiseSeed << " " << result.connectivitySeed << " " << result.nbSpikes << " " << result.rate << " " << result.cv << " " << result.time << std::endl;
+}
+
+void ParameterSweep::writeSummary() const{
+
+    std::ofstream file(config_.getSummary());
+    if(file.fail())
+        throw(std::string("Impossible to open the summary file ") + config_.getSummary());
+
+    writeSummary(file);
+}
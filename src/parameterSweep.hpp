@@ -0,0 +1,132 @@
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include "simulationConfig.hpp"
+#include "connectivity.hpp"
+
+
+//!  Struct SweepResult
+/*!
+ Summary of the simulation of one point (g, eta) of a parameter sweep
+ */
+struct SweepResult{
+
+    double g; //!< Ratio Ji/Je of the point
+    double eta; //!< Ratio Vext/Vthr of the point
+    unsigned long int noiseSeed; //!< Seed of the background noise
+    unsigned long int connectivitySeed; //!< Seed of the connections
+    unsigned long int nbSpikes; //!< Number of spikes between the start and the stop time
+    double rate; //!< Mean firing rate of a neuron between the start and the stop time, in [Hz]
+    double cv; //!< Mean coefficient of variation of the interspike intervals of the neurons (see SpikeStatistics), -1 if no neuron has spiked 3 times
+    double time; //!< Duration of the simulation of the point, in [s]
+    std::string spikesFileName; //!< Binary file of the spikes of the point, empty if they are not written
+};
+
+
+//!  Class ParameterSweep
+/*!
+ This class simulates all the points of a grid of values of g and eta (figure 8 of Brunel's paper), with the other parameters of a SimulationConfig.
+
+ The connections don't depend on g and eta : they are generated once, and the same frozen Connectivity is shared by the networks of all the points, which only create their neurons.
+ The points are simulated one after the other, or sweep-jobs at a time by as many threads (each network can also use several threads). All the points use the same seed of the background noise.
+ The result of each point (number of spikes, mean rate, CV of the ISIs, duration) is written in a summary file, and the spikes and the statistics of each point can be written in their own files.
+ */
+
+class ParameterSweep{
+
+    private:
+
+    SimulationConfig config_; //!< The parameters of the simulations, and the grid
+    std::vector<double> gValues_; //!< The values of g of the grid
+    std::vector<double> etaValues_; //!< The values of eta of the grid
+    std::vector<SweepResult> results_; //!< The results of the points, the point i has g = gValues_[i/etaValues_.size()] and eta = etaValues_[i%etaValues_.size()]
+    unsigned long int connectivitySeed_; //!< Seed of the connections shared by all the points, known once they are generated
+    std::atomic<size_t> nextPoint_; //!< Index of the next point to simulate, shared by the threads
+    std::mutex logMutex_; //!< Protects the log, written by all the threads
+
+
+    /*********************************************************************/
+
+    /**
+     * Loop of a thread : simulates points until all the points have been taken
+     * @param connections are the connections shared by all the points
+     * @param noiseSeed is the seed of the background noise
+     * @param log is the stream where the progression is written
+     */
+    void runPoints(Connectivity const& connections, unsigned long int const& noiseSeed, std::ostream& log);
+
+    /**
+     * Simulates one point of the grid and fills its result
+     * @param index is the index of the point
+     * @param connections are the connections shared by all the points
+     * @param noiseSeed is the seed of the background noise
+     */
+    void runPoint(size_t const& index, Connectivity const& connections, unsigned long int const& noiseSeed);
+
+    /**
+     * Simulates one point of the grid with the neurons in a precision and fills its result
+     * @param index is the index of the point
+     * @param connections are the connections shared by all the points
+     * @param noiseSeed is the seed of the background noise
+     */
+    template<typename Precision>
+    void simulatePoint(size_t const& index, Connectivity const& connections, unsigned long int const& noiseSeed);
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Constructor of a sweep, nothing is simulated
+     * @param config contains the parameters and the grid, already validated
+     */
+    ParameterSweep(SimulationConfig const& config);
+
+    /**
+     * @return the number of points of the grid
+     */
+    size_t getNbPoints() const;
+    /**
+     * @return the results of the points, complete after run
+     */
+    std::vector<SweepResult> const& getResults() const;
+
+    /**
+     * Name of the file of a point, made from the name of a file of the config
+     * @param fileName is the name of the file of the config (../result/spikes.bin for example)
+     * @param g is the g of the point
+     * @param eta is the eta of the point
+     * @return the name of the file of the point (../result/spikes_g5_eta2.bin for example)
+     */
+    static std::string getPointFileName(std::string const& fileName, double const& g, double const& eta);
+
+    /*********************************************************************/
+
+    /**
+     * Generates the connections, then simulates all the points
+     * @param log is the stream where the progression is written
+     */
+    void run(std::ostream& log);
+
+    /**
+     * Writes the results of the points, one line "g eta seed spikes rate cv time" per point
+     * @param out is the stream where the results are written
+     */
+    void writeSummary(std::ostream& out) const;
+    /**
+     * Writes the results of the points in the summary file of the config
+     * @throw std::string if the file can't be opened
+     */
+    void writeSummary() const;
+
+};
+
+#endif
@@ -0,0 +1,66 @@
+#include "physicsParameters.hpp"
+#include "../Utility/Constants.h"
+#include <cassert>
+
+PhysicsParameters::PhysicsParameters()
+: PhysicsParameters(h, Delay, Je, tau, epsilon)
+{}
+
+PhysicsParameters::PhysicsParameters(double const& h, double const& delay, double const& Je, double const& tau, double const& epsilon)
+: h_(h), delay_(delay), Je_(Je), tau_(tau), epsilon_(epsilon)
+{
+    assert(h_ > 0 and tau_ > 0);
+
+    //Same expressions as in Utility/Constants.h
+    delayInSteps_ = static_cast<unsigned long>(ceil(delay_/h_));
+    refractoryTimeStep_ = static_cast<unsigned long>(ceil(refractoryTime/h_));
+    scalarCste1_ = exp(-h_/tau_);
+    scalarCste2_ = (tau_/C)*(1-scalarCste1_);
+
+    assert(delayInSteps_ > 0);
+}
+
+double PhysicsParameters::getH() const{
+
+    return h_;
+}
+
+double PhysicsParameters::getDelay() const{
+
+    return delay_;
+}
+
+double PhysicsParameters::getJe() const{
+
+    return Je_;
+}
+
+double PhysicsParameters::getTau() const{
+
+    return tau_;
+}
+
+double PhysicsParameters::getEpsilon() const{
+
+    return epsilon_;
+}
+
+unsigned int PhysicsParameters::getDelayInSteps() const{
+
+    return delayInSteps_;
+}
+
+double PhysicsParameters::getRefractoryTimeStep() const{
+
+    return refractoryTimeStep_;
+}
+
+double PhysicsParameters::getScalarCste1() const{
+
+    return scalarCste1_;
+}
+
+double PhysicsParameters::getScalarCste2() const{
+
+    return scalarCste2_;
+}
@@ -0,0 +1,89 @@
+#ifndef PHYSICS_PARAMETERS_H
+#define PHYSICS_PARAMETERS_H
+
+#include <cstddef>
+
+
+//!  Class PhysicsParameters
+/*!
+ This class contains the physical parameters of a simulation that can be chosen at runtime (h, Delay, Je, tau, epsilon), and the constants of the membrane equation derived from them.
+ The default values are the ones of Utility/Constants.h, the derived constants are computed with the same expressions, so that a default PhysicsParameters gives exactly the same simulation as the constants.
+ */
+
+class PhysicsParameters{
+
+    private:
+
+    double h_; //!< Duration of a timeStep in [ms]
+    double delay_; //!< Delay for the transmission of a spike in [ms]
+    double Je_; //!< Amplitude of the signal sent by an excitatory neuron in [mV]
+    double tau_; //!< C*R [ms]
+    double epsilon_; //!< Ce = epsilon * Ne, Ci = epsilon * Ni
+
+    unsigned int delayInSteps_; //!< delay_ in timeSteps
+    double refractoryTimeStep_; //!< refractoryTime in timeSteps
+    double scalarCste1_; //!< exp(-h/tau), used in the membrane equation
+    double scalarCste2_; //!< R*(1-scalarCste1_), used in the membrane equation
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Constructor with the values of Utility/Constants.h
+     */
+    PhysicsParameters();
+    /**
+     * Constructor, the parameters have to be valid (see SimulationConfig::validate)
+     * @param h is the duration of a timeStep in [ms]
+     * @param delay is the delay of the connections in [ms], at least one timeStep
+     * @param Je is the amplitude of an excitatory spike in [mV]
+     * @param tau is the time constant of the membrane in [ms]
+     * @param epsilon is the ratio of connections
+     */
+    PhysicsParameters(double const& h, double const& delay, double const& Je, double const& tau, double const& epsilon);
+
+    /**
+     * @return h_
+     */
+    double getH() const;
+    /**
+     * @return delay_
+     */
+    double getDelay() const;
+    /**
+     * @return Je_
+     */
+    double getJe() const;
+    /**
+     * @return tau_
+     */
+    double getTau() const;
+    /**
+     * @return epsilon_
+     */
+    double getEpsilon() const;
+
+    /**
+     * @return delayInSteps_
+     */
+    unsigned int getDelayInSteps() const;
+    /**
+     * @return refractoryTimeStep_
+     */
+    double getRefractoryTimeStep() const;
+    /**
+     * @return scalarCste1_
+     */
+    double getScalarCste1() const;
+    /**
+     * @return scalarCste2_
+     */
+    double getScalarCste2() const;
+
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef PRECISION_H
+#define PRECISION_H
+
+#include <string>
+
+
+//!  Struct PrecisionPolicy
+/*!
+ This struct chooses the floating point types of the state of the neurons, it is the template parameter of BasicNeuronPopulation and BasicNetwork :
+ State is the type of the membrane potentials, of the times of the last spike, of the external currents and of the constants of the membrane equation, Input is the type of the buffers of the spikes.
+
+ The dynamics (threshold of 20 mV, Je of 0.1 mV, counts of spikes) are representable in float : a float state doubles the number of neurons per vector of the MembraneKernel and halves the memory traffic of the update.
+ The times of the last spike are exact in float until 2^24 timeSteps (1677 s with h = 0.1 ms).
+ In the mixed precision the buffers are in float, which is exact for the numbers of spikes and for the values of g with few bits (3, 4.5, 5, 6...), and the potentials stay in double.
+ The results of SinglePrecision and MixedPrecision are not the same as the ones of DoublePrecision : the trajectories of a chaotic network diverge, only the statistics of the population are comparable (see PrecisionValidation).
+ */
+
+template<typename StateType, typename InputType>
+struct PrecisionPolicy{
+
+    typedef StateType State; //!< Type of the membrane potentials, times of the last spike, currents and constants of the membrane equation
+    typedef InputType Input; //!< Type of the buffers of the spikes
+
+    /**
+     * @return the name of the policy ("double", "float" or "mixed"), the value of the parameter precision of SimulationConfig
+     */
+    static std::string getName();
+};
+
+typedef PrecisionPolicy<double, double> DoublePrecision; //!< Reference precision, bit-identical to the class Neuron
+typedef PrecisionPolicy<float, float> SinglePrecision; //!< Everything in float
+typedef PrecisionPolicy<double, float> MixedPrecision; //!< Potentials in double, buffers in float
+
+template<>
+inline std::string DoublePrecision::getName(){
+
+    return "double";
+}
+
+template<>
+inline std::string SinglePrecision::getName(){
+
+    return "float";
+}
+
+template<>
+inline std::string MixedPrecision::getName(){
+
+    return "mixed";
+}
+
+#endif
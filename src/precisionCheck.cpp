@@ -0,0 +1,37 @@
+#include "precisionValidation.hpp"
+#include <iostream>
+
+using namespace std;
+
+/**
+ * Compares the statistics of the population simulated in float and in mixed precision with the ones of the reference in double (see PrecisionValidation)
+ * Usage : PrecisionCheck [the options of Neuron], the precision is ignored. Returns 2 if a precision is not within the tolerances
+ */
+int main(int argc, char* argv[]){
+
+    for(int i(1) ; i < argc ; ++i){
+        if(string(argv[i]) == "--help"){
+            cout << SimulationConfig::getUsage();
+            return 0;
+        }
+    }
+
+    SimulationConfig config;
+    try{
+        config = SimulationConfig::fromCommandLine(argc, argv);
+    }
+    catch(string errorMsg){
+        cerr << errorMsg << endl;
+        return 1;
+    }
+    if(config.isSweep()){
+        cerr << "PrecisionCheck simulates one point, without sweep-g and sweep-eta" << endl;
+        return 1;
+    }
+
+    PrecisionValidation validation(config);
+    validation.run(cout);
+    validation.writeReport(cout);
+
+    return validation.passed() ? 0 : 2;
+}
@@ -0,0 +1,133 @@
+#include "precisionValidation.hpp"
+#include "network.hpp"
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+PrecisionValidation::PrecisionValidation(SimulationConfig const& config)
+: config_(config), connectivitySeed_(0), rateTolerance_(0.05), cvTolerance_(0.05), synchronyTolerance_(0.2)
+{}
+
+void PrecisionValidation::setTolerances(double const& rate, double const& cv, double const& synchrony){
+
+    assert(rate >= 0 and cv >= 0 and synchrony >= 0);
+    rateTolerance_ = rate;
+    cvTolerance_ = cv;
+    synchronyTolerance_ = synchrony;
+}
+
+double PrecisionValidation::getSynchrony(std::vector<uint32_t> const& histogram){
+
+    if(histogram.empty())
+        return 0;
+
+    double sum(0), squareSum(0);
+    for(auto count : histogram){
+        sum += count;
+        squareSum += double(count)*count;
+    }
+    double mean(sum/histogram.size());
+    if(mean == 0)
+        return 0;
+    return sqrt(std::max(squareSum/histogram.size() - mean*mean, 0.0))/mean;
+}
+
+/*********************************************************************/
+
+template<typename Precision>
+PrecisionResult PrecisionValidation::simulate(std::string const& name, Connectivity const& connections, unsigned long int const& noiseSeed) const{
+
+    std::chrono::steady_clock::time_point begin(std::chrono::steady_clock::now());
+    PhysicsParameters physics(config_.getPhysics());
+
+    BasicNetwork<Precision> net(true, config_.getG(), config_.getEta(), config_.getNbNeurons(), connectivitySeed_, noiseSeed, physics);
+    net.setNbThreads(config_.getNbThreads());
+    net.setSpikeCounters(config_.getSpikeCounters());
+    net.setProceduralConnectivity(config_.getProceduralConnectivity());
+    net.setDelivery(config_.getDelivery());
+    net.setSpikesFileName("");
+    net.enableStatistics(config_.getBinSteps());
+    net.createNetwork(connections);
+
+    //Change ms into timesteps, like the main program
+    double Stopstep = static_cast<unsigned long>(ceil(config_.getStop()/physics.getH()));
+    double Startstep = static_cast<unsigned long>(ceil(config_.getStart()/physics.getH()));
+    net.updateNetwork(Startstep, Stopstep);
+
+    SpikeStatistics const& statistics(net.getStatistics());
+    PrecisionResult result;
+    result.name = name;
+    result.noiseSeed = noiseSeed;
+    result.nbSpikes = net.getNbRecordedSpikes();
+    result.rate = statistics.getMeanRate(physics.getH());
+    result.cv = statistics.getMeanCV();
+    result.synchrony = getSynchrony(statistics.getHistogram());
+    result.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    result.passed = true;
+    return result;
+}
+
+void PrecisionValidation::run(std::ostream& log){
+
+    //The connections are generated once by a network without background noise, like in ParameterSweep
+    Network builder(false, config_.getG(), config_.getEta(), config_.getNbNeurons(), config_.getPhysics());
+    if(config_.hasConnectivitySeed())
+        builder.setConnectivitySeed(config_.getConnectivitySeed());
+    builder.setConnectivityCache(config_.getConnectivityCache());
+    builder.setProceduralConnectivity(config_.getProceduralConnectivity());
+    builder.createNetwork();
+    Connectivity connections(builder.neuronConnections_);
+    connectivitySeed_ = builder.getConnectivitySeed();
+
+    //The same noise for all the precisions, random if it is not given
+    unsigned long int noiseSeed(config_.getSeed());
+    if(!config_.hasSeed()){
+        std::random_device rd;
+        noiseSeed = rd();
+    }
+
+    results_.clear();
+    results_.push_back(simulate<DoublePrecision>(DoublePrecision::getName(), connections, noiseSeed));
+    results_.push_back(simulate<DoublePrecision>(DoublePrecision::getName() + ", other noise", connections, noiseSeed + 1));
+    results_.push_back(simulate<SinglePrecision>(SinglePrecision::getName(), connections, noiseSeed));
+    results_.push_back(simulate<MixedPrecision>(MixedPrecision::getName(), connections, noiseSeed));
+
+    //The differences due to the noise alone : a precision is not asked to be closer to the reference than twice this
+    PrecisionResult const& reference(results_[0]);
+    PrecisionResult const& otherNoise(results_[1]);
+    double rateTolerance(std::max(rateTolerance_*reference.rate, 2*std::abs(otherNoise.rate - reference.rate)));
+    double cvTolerance(std::max(cvTolerance_, 2*std::abs(otherNoise.cv - reference.cv)));
+    double synchronyTolerance(std::max(synchronyTolerance_*reference.synchrony, 2*std::abs(otherNoise.synchrony - reference.synchrony)));
+
+    for(auto& result : results_){
+        //A CV of -1 (not enough spikes) only matches another -1
+        result.passed = std::abs(result.rate - reference.rate) <= rateTolerance
+                    and std::abs(result.cv - reference.cv) <= cvTolerance
+                    and std::abs(result.synchrony - reference.synchrony) <= synchronyTolerance;
+        log << result.name << " : " << result.rate << " Hz, CV " << result.cv << ", synchrony " << result.synchrony << " (" << result.time << " s)" << (result.passed ? "" : " FAILED") << std::endl;
+    }
+}
+
+std::vector<PrecisionResult> const& PrecisionValidation::getResults() const{
+
+    return results_;
+}
+
+bool PrecisionValidation::passed() const{
+
+    for(auto const& result : results_){
+        if(!result.passed)
+            return false;
+    }
+    return !results_.empty();
+}
+
+void PrecisionValidation::writeReport(std::ostream& out) const{
+
+    out << "# tolerances : rate " << rateTolerance_ << " (relative), cv " << cvTolerance_ << ", synchrony " << synchronyTolerance_ << " (relative)" << std::endl;
+    out << "# name seed spikes rate[Hz] cv synchrony time[s] passed" << std::endl;
+    for(auto const& result : results_)
+        out << "\"" << result.name << "\" " << result.noiseSeed << " " << result.nbSpikes << " " << result.rate << " " << result.cv << " " << result.synchrony << " " << result.time << " " << result.passed << std::endl;
+}
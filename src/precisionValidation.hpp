@@ -0,0 +1,115 @@
+#ifndef PRECISION_VALIDATION_H
+#define PRECISION_VALIDATION_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <ostream>
+#include "simulationConfig.hpp"
+#include "connectivity.hpp"
+#include "precision.hpp"
+
+
+//!  Struct PrecisionResult
+/*!
+ Statistics of the population in one simulation of a PrecisionValidation
+ */
+struct PrecisionResult{
+
+    std::string name; //!< Name of the simulation ("double", "double, other noise", "float" or "mixed")
+    unsigned long int noiseSeed; //!< Seed of the background noise
+    unsigned long int nbSpikes; //!< Number of spikes between the start and the stop time
+    double rate; //!< Mean firing rate of a neuron, in [Hz]
+    double cv; //!< Mean coefficient of variation of the interspike intervals (see SpikeStatistics), -1 if no neuron has spiked 3 times
+    double synchrony; //!< Coefficient of variation of the histogram of the population : 0 for a constant activity, large for oscillations
+    double time; //!< Duration of the simulation, in [s]
+    bool passed; //!< True if the statistics are within the tolerances of the ones of the reference
+};
+
+
+//!  Class PrecisionValidation
+/*!
+ This class checks that the simulations in SinglePrecision and MixedPrecision reproduce the statistics of the population of the reference in DoublePrecision.
+ The network of a SimulationConfig is simulated with the same connections and the same background noise in double, in float and in mixed precision : the trajectories diverge after some timeSteps (the network is chaotic), so the spikes can't be compared one by one, only the mean rate, the mean CV of the ISIs and the synchrony of the population.
+
+ To give a scale to the differences, the reference is also simulated with another seed of the background noise : a difference due to the precision should be of the same order as the one due to the noise.
+ A precision passes if its rate is within rateTolerance (relative), its CV within cvTolerance (absolute) and its synchrony within synchronyTolerance (relative) of the ones of the reference, or within twice the difference between the reference and the other noise if it is larger (low rates, short simulations).
+ */
+
+class PrecisionValidation{
+
+    private:
+
+    SimulationConfig config_; //!< The parameters of the network, the precision of the config is ignored
+    unsigned long int connectivitySeed_; //!< Seed of the connections shared by all the simulations, known once they are generated
+    double rateTolerance_; //!< Maximal relative difference of the mean rate with the reference, 0.05 by default
+    double cvTolerance_; //!< Maximal difference of the mean CV with the reference, 0.05 by default
+    double synchronyTolerance_; //!< Maximal relative difference of the synchrony with the reference, 0.2 by default
+    std::vector<PrecisionResult> results_; //!< The reference, the reference with another noise, float and mixed
+
+
+    /*********************************************************************/
+
+    /**
+     * Simulates the network of the config in a precision
+     * @param name is the name of the simulation
+     * @param connections are the connections shared by all the simulations
+     * @param noiseSeed is the seed of the background noise
+     * @return the statistics of the simulation (passed is not set)
+     */
+    template<typename Precision>
+    PrecisionResult simulate(std::string const& name, Connectivity const& connections, unsigned long int const& noiseSeed) const;
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Constructor of a validation, nothing is simulated
+     * @param config contains the parameters of the network, already validated
+     */
+    PrecisionValidation(SimulationConfig const& config);
+
+    /**
+     * Chooses the tolerances of the comparison with the reference
+     * @param rate is the maximal relative difference of the mean rate
+     * @param cv is the maximal difference of the mean CV
+     * @param synchrony is the maximal relative difference of the synchrony
+     */
+    void setTolerances(double const& rate, double const& cv, double const& synchrony);
+
+    /**
+     * @param histogram is the number of spikes of the population in each bin
+     * @return the standard deviation of the histogram divided by its mean, 0 if it is empty
+     */
+    static double getSynchrony(std::vector<uint32_t> const& histogram);
+
+    /*********************************************************************/
+
+    /**
+     * Generates the connections, then simulates the reference, the reference with another noise, float and mixed, and compares them with the reference
+     * @param log is the stream where the progression is written
+     */
+    void run(std::ostream& log);
+
+    /**
+     * @return the results of the simulations, the reference first, complete after run
+     */
+    std::vector<PrecisionResult> const& getResults() const;
+    /**
+     * @return true if all the simulations are within the tolerances of the reference
+     */
+    bool passed() const;
+
+    /**
+     * Writes the results, one line "name seed spikes rate cv synchrony time passed" per simulation, after the tolerances
+     * @param out is the stream where the results are written
+     */
+    void writeReport(std::ostream& out) const;
+
+};
+
+#endif
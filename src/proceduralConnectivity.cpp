@@ -0,0 +1,55 @@
+#include "proceduralConnectivity.hpp"
+#include <cassert>
+
+namespace {
+
+    /**
+     * @param seed is a seed of the connections
+     * @return the beginning of its stream : the finalizer of SplitMix64, so that two close seeds don't give two shifted copies of the same stream
+     */
+    uint64_t streamKey(uint64_t seed){
+
+        seed = (seed ^ (seed >> 30))*0xBF58476D1CE4E5B9ULL;
+        seed = (seed ^ (seed >> 27))*0x94D049BB133111EBULL;
+        return seed ^ (seed >> 31);
+    }
+}
+
+ProceduralConnectivity::ProceduralConnectivity()
+: ProceduralConnectivity(0, 0, 0)
+{}
+
+ProceduralConnectivity::ProceduralConnectivity(unsigned long int const& nbNeurons, size_t const& nbTargets, uint64_t const& seed)
+: nbNeurons_(nbNeurons), nbTargets_(nbTargets), seed_(seed), key_(streamKey(seed))
+{
+    assert(nbNeurons_ <= UINT32_MAX);
+}
+
+size_t ProceduralConnectivity::size() const{
+
+    return nbNeurons_;
+}
+
+size_t ProceduralConnectivity::getNbTargets() const{
+
+    return nbTargets_;
+}
+
+size_t ProceduralConnectivity::getNbSynapses() const{
+
+    return nbNeurons_*nbTargets_;
+}
+
+uint64_t ProceduralConnectivity::getSeed() const{
+
+    return seed_;
+}
+
+std::vector<uint32_t> ProceduralConnectivity::getTargets(size_t const& source) const{
+
+    assert(source < size());
+    std::vector<uint32_t> targets(nbTargets_);
+    for(size_t k(0) ; k < nbTargets_ ; ++k)
+        targets[k] = getTarget(source, k);
+    return targets;
+}
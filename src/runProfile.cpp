@@ -0,0 +1,159 @@
+#include "runProfile.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+
+RunProfile::RunProfile()
+: nbNeurons_(0), nbSteps_(0), wallTime_(0)
+{}
+
+/*********************************************************************/
+
+bool RunProfile::isEnabled(){
+
+#ifdef NEURON_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::string RunProfile::getName(Phase const& phase){
+
+    switch(phase){
+        case Noise:
+            return "noise";
+        case Integration:
+            return "integration";
+        case Barrier:
+            return "barrier";
+        case Delivery:
+            return "delivery";
+        case Output:
+            return "output";
+        default:
+            return "";
+    }
+}
+
+void RunProfile::prepare(size_t const& nbThreads, unsigned long int const& nbNeurons){
+
+    nbNeurons_ = nbNeurons;
+    while(threads_.size() < nbThreads){
+        ThreadCounters counters;
+        std::memset(&counters, 0, sizeof(counters));
+        threads_.push_back(counters);
+    }
+}
+
+RunProfile::ThreadCounters& RunProfile::getThread(size_t const& thread){
+
+    assert(thread < threads_.size());
+    return threads_[thread];
+}
+
+void RunProfile::addRun(unsigned long int const& nbSteps, double const& wallTime){
+
+    nbSteps_ += nbSteps;
+    wallTime_ += wallTime;
+}
+
+/*********************************************************************/
+
+unsigned long int RunProfile::getNbSteps() const{
+
+    return nbSteps_;
+}
+
+double RunProfile::getWallTime() const{
+
+    return wallTime_;
+}
+
+double RunProfile::getPhaseTime(Phase const& phase) const{
+
+    if(threads_.empty())
+        return 0;
+
+    uint64_t nanoseconds(0);
+    for(auto const& counters : threads_)
+        nanoseconds += counters.nanoseconds[phase];
+    return nanoseconds*1e-9/threads_.size();
+}
+
+uint64_t RunProfile::getNbSpikes() const{
+
+    uint64_t nb(0);
+    for(auto const& counters : threads_)
+        nb += counters.nbSpikes;
+    return nb;
+}
+
+uint64_t RunProfile::getNbSynapticEvents() const{
+
+    uint64_t nb(0);
+    for(auto const& counters : threads_)
+        nb += counters.nbSynapticEvents;
+    return nb;
+}
+
+/*********************************************************************/
+
+void RunProfile::print(std::ostream& out) const{
+
+    out << "Profile of the run : " << nbSteps_ << " timeSteps in " << wallTime_ << " s, " << threads_.size() << " threads" << std::endl;
+    if(!isEnabled()){
+        out << "  (phases not measured, compile with -DNEURON_PROFILING=ON)" << std::endl;
+        return;
+    }
+
+    //The phases are averaged over the threads
+    for(int phase(0) ; phase < NbPhases ; ++phase){
+        double time(getPhaseTime(static_cast<Phase>(phase)));
+        out << "  " << getName(static_cast<Phase>(phase)) << " : " << time << " s, " << (nbSteps_ > 0 ? time/nbSteps_*1e6 : 0) << " us/step, " << (wallTime_ > 0 ? 100*time/wallTime_ : 0) << " %" << std::endl;
+    }
+
+    uint64_t maxStep(0);
+    for(auto const& counters : threads_)
+        maxStep = std::max(maxStep, counters.maxStep);
+    out << "  longest window : " << maxStep*1e-3 << " us" << std::endl;
+
+    if(wallTime_ > 0){
+        out << "  " << getNbSpikes() << " spikes, " << getNbSynapticEvents() << " synaptic events" << std::endl;
+        out << "  " << nbSteps_*nbNeurons_/wallTime_ << " neuron-updates/s, " << getNbSynapticEvents()/wallTime_ << " synaptic-events/s" << std::endl;
+    }
+}
+
+void RunProfile::writeJson(std::ostream& out) const{
+
+    uint64_t maxStep(0);
+    for(auto const& counters : threads_)
+        maxStep = std::max(maxStep, counters.maxStep);
+
+    out << "{" << std::endl;
+    out << "  \"enabled\": " << (isEnabled() ? "true" : "false") << "," << std::endl;
+    out << "  \"threads\": " << threads_.size() << "," << std::endl;
+    out << "  \"neurons\": " << nbNeurons_ << "," << std::endl;
+    out << "  \"steps\": " << nbSteps_ << "," << std::endl;
+    out << "  \"wallTime\": " << wallTime_ << "," << std::endl;
+    out << "  \"phases\": {";
+    for(int phase(0) ; phase < NbPhases ; ++phase)
+        out << (phase > 0 ? ", " : "") << "\"" << getName(static_cast<Phase>(phase)) << "\": " << getPhaseTime(static_cast<Phase>(phase));
+    out << "}," << std::endl;
+    out << "  \"maxStep\": " << maxStep*1e-9 << "," << std::endl;
+    out << "  \"spikes\": " << getNbSpikes() << "," << std::endl;
+    out << "  \"synapticEvents\": " << getNbSynapticEvents() << "," << std::endl;
+    out << "  \"neuronUpdatesPerSecond\": " << (wallTime_ > 0 ? nbSteps_*nbNeurons_/wallTime_ : 0) << "," << std::endl;
+    out << "  \"synapticEventsPerSecond\": " << (wallTime_ > 0 ? getNbSynapticEvents()/wallTime_ : 0) << std::endl;
+    out << "}" << std::endl;
+}
+
+void RunProfile::writeJson(std::string const& fileName) const{
+
+    std::ofstream file(fileName);
+    if(file.fail())
+        throw(std::string("Impossible to open the profile file ") + fileName);
+
+    writeJson(file);
+}
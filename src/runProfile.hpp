@@ -0,0 +1,211 @@
+#ifndef RUN_PROFILE_H
+#define RUN_PROFILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+//!  Class RunProfile
+/*!
+ This class measures where the time of Network::updateNetwork goes : each thread accumulates the time of each phase of a timeStep (background noise, integration of the membranes, waiting at the barriers, delivery of the spikes, output of the spikes), and counts the spikes and the synaptic events (one spike delivered to one target) it handles.
+
+ The measures are only compiled with the option NEURON_PROFILING of CMake (the macro NEURON_PROFILING) : without it, PhaseClock is empty and its calls disappear, the simulation is not slowed down at all. With it, a timeStep costs a few reads of std::chrono::steady_clock per thread.
+ The counters of each thread are on their own cache lines, so that the threads don't slow each other down. At the end of the run, the profile is printed (time per phase, per step, throughput) or exported as JSON.
+ */
+
+class RunProfile{
+
+    public:
+
+    //!  Enum Phase
+    /*!
+     The phases of a timeStep
+     */
+    enum Phase{
+        Noise, //!< Draws of the background noise, added to the buffers
+        Integration, //!< Update of the membrane potentials
+        Barrier, //!< Waiting for the other threads
+        Delivery, //!< Delivery of the spikes to the targets of the range
+        Output, //!< Statistics and recording of the spikes (thread 0)
+        NbPhases //!< Number of phases
+    };
+
+    //!  Struct ThreadCounters
+    /*!
+     The counters of one thread, alone on their cache lines
+     */
+    struct ThreadCounters{
+
+        char paddingBefore[64]; //!< Separates the counters from the ones of the previous thread
+        uint64_t nanoseconds[NbPhases]; //!< Time spent in each phase, in [ns]
+        uint64_t nbSpikes; //!< Number of spikes of the neurons of the range
+        uint64_t nbSynapticEvents; //!< Number of spikes delivered to the targets of the range
+        uint64_t maxStep; //!< Longest window of timeSteps (sum of the phases), in [ns]
+        char paddingAfter[64]; //!< Separates the counters from the ones of the next thread
+    };
+
+    //!  Class PhaseClock
+    /*!
+     Measures the successive phases of a thread : lap adds the time since the previous lap to a phase. Empty without NEURON_PROFILING
+     */
+    class PhaseClock{
+
+#ifdef NEURON_PROFILING
+        std::chrono::steady_clock::time_point last_; //!< Time of the previous lap
+        std::chrono::steady_clock::time_point stepBegin_; //!< Beginning of the current timeStep
+#endif
+
+        public:
+
+        /**
+         * Begins a window of timeSteps (see Network::getWindowSteps)
+         */
+        void startStep(){
+#ifdef NEURON_PROFILING
+            last_ = stepBegin_ = std::chrono::steady_clock::now();
+#endif
+        }
+
+        /**
+         * Adds the time since the previous lap to a phase
+         * @param counters are the counters of the thread
+         * @param phase is the phase that has just ended
+         */
+        void lap(ThreadCounters& counters, Phase const& phase){
+#ifdef NEURON_PROFILING
+            std::chrono::steady_clock::time_point now(std::chrono::steady_clock::now());
+            counters.nanoseconds[phase] += std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_).count();
+            last_ = now;
+#else
+            (void)counters;
+            (void)phase;
+#endif
+        }
+
+        /**
+         * Counts the spikes handled by the thread during a timeStep
+         * @param counters are the counters of the thread
+         * @param nbSpikes is the number of spikes of the neurons of the range
+         * @param nbSynapticEvents is the number of spikes delivered to the targets of the range
+         */
+        void count(ThreadCounters& counters, uint64_t const& nbSpikes, uint64_t const& nbSynapticEvents){
+#ifdef NEURON_PROFILING
+            counters.nbSpikes += nbSpikes;
+            counters.nbSynapticEvents += nbSynapticEvents;
+#else
+            (void)counters;
+            (void)nbSpikes;
+            (void)nbSynapticEvents;
+#endif
+        }
+
+        /**
+         * Ends a window of timeSteps, to keep the longest one
+         * @param counters are the counters of the thread
+         */
+        void endStep(ThreadCounters& counters){
+#ifdef NEURON_PROFILING
+            uint64_t step(std::chrono::duration_cast<std::chrono::nanoseconds>(last_ - stepBegin_).count());
+            if(step > counters.maxStep)
+                counters.maxStep = step;
+#else
+            (void)counters;
+#endif
+        }
+    };
+
+    private:
+
+    std::vector<ThreadCounters> threads_; //!< The counters of each thread
+    unsigned long int nbNeurons_; //!< Number of neurons of the network
+    unsigned long int nbSteps_; //!< Number of timeSteps simulated
+    double wallTime_; //!< Duration of the runs, in [s]
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Constructor of an empty profile
+     */
+    RunProfile();
+
+    /**
+     * @return true if the program is compiled with NEURON_PROFILING
+     */
+    static bool isEnabled();
+    /**
+     * @param phase is a phase
+     * @return the name of the phase
+     */
+    static std::string getName(Phase const& phase);
+
+    /**
+     * Adds threads to the profile if needed, the counters are kept
+     * @param nbThreads is the number of threads of the run
+     * @param nbNeurons is the number of neurons of the network
+     */
+    void prepare(size_t const& nbThreads, unsigned long int const& nbNeurons);
+    /**
+     * @param thread is the index of a thread
+     * @return its counters
+     */
+    ThreadCounters& getThread(size_t const& thread);
+    /**
+     * Adds a run to the profile
+     * @param nbSteps is the number of timeSteps of the run
+     * @param wallTime is the duration of the run, in [s]
+     */
+    void addRun(unsigned long int const& nbSteps, double const& wallTime);
+
+    /*********************************************************************/
+
+    /**
+     * @return the number of timeSteps simulated
+     */
+    unsigned long int getNbSteps() const;
+    /**
+     * @return the duration of the runs, in [s]
+     */
+    double getWallTime() const;
+    /**
+     * @param phase is a phase
+     * @return the time of the phase, averaged over the threads, in [s]
+     */
+    double getPhaseTime(Phase const& phase) const;
+    /**
+     * @return the number of spikes of all the threads
+     */
+    uint64_t getNbSpikes() const;
+    /**
+     * @return the number of synaptic events of all the threads
+     */
+    uint64_t getNbSynapticEvents() const;
+
+    /**
+     * Prints the time of each phase (total, per timeStep and share of the run), the longest window of timeSteps and the throughput
+     * @param out is the stream where the profile is printed
+     */
+    void print(std::ostream& out) const;
+    /**
+     * Writes the profile as a JSON object
+     * @param out is the stream where the profile is written
+     */
+    void writeJson(std::ostream& out) const;
+    /**
+     * Writes the profile in a JSON file
+     * @param fileName is the name of the file
+     * @throw std::string if the file can't be written
+     */
+    void writeJson(std::string const& fileName) const;
+
+};
+
+#endif
@@ -0,0 +1,525 @@
+#include "simulationConfig.hpp"
+#include "../Utility/Constants.h"
+#include "precision.hpp"
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include <cerrno>
+#include <algorithm>
+
+namespace {
+
+    /**
+     * Keys of the values of the old positional format of param.in, in their order
+     */
+    const char* const positionalKeys[] = {"g", "eta", "neurons", "start", "stop", "threads"};
+
+    /**
+     * @param s is a string
+     * @return s without the spaces at its beginning and at its end
+     */
+    std::string trim(std::string const& s){
+
+        size_t begin(s.find_first_not_of(" \t\r"));
+        if(begin == std::string::npos)
+            return "";
+        size_t end(s.find_last_not_of(" \t\r"));
+        return s.substr(begin, end - begin + 1);
+    }
+
+    /**
+     * Converts a value into a number, the whole value has to be read
+     * @param value is the value
+     * @param key is the name of the parameter, for the error message
+     * @param origin is the place where the value was read, for the error message
+     * @return the number
+     * @throw std::string if the value is not a number
+     */
+    double toNumber(std::string const& value, std::string const& key, std::string const& origin){
+
+        char* end(nullptr);
+        errno = 0;
+        double number(std::strtod(value.c_str(), &end));
+        if(value.empty() or *end != '\0' or errno != 0)
+            throw(std::string("Invalid argument: ") + key + " must be a number, not \"" + value + "\" (" + origin + ")");
+        return number;
+    }
+
+    /**
+     * @param number is a number
+     * @return true if number is an integer
+     */
+    bool isInteger(double const& number){
+
+        return number == floor(number);
+    }
+}
+
+SimulationConfig::SimulationConfig()
+: g_(5), eta_(2), nbNeurons_(12500), start_(1000), stop_(1200), hasSeed_(false), seed_(0), hasConnectivitySeed_(false), connectivitySeed_(0), nbThreads_(1), spikeCounters_(false), proceduralConnectivity_(false), compactConnectivity_(false), delivery_("push"), pullThreshold_(1), precision_("double"), output_("../result/spikes.bin"), bin_(h),
+  h_(h), delay_(Delay), Je_(Je), tau_(tau), epsilon_(epsilon), sweepJobs_(1), sweepSpikes_(false), summary_("../result/sweep.txt")
+{}
+
+SimulationConfig SimulationConfig::fromCommandLine(int argc, const char* const argv[]){
+
+    SimulationConfig config;
+
+    //The file is read first, so that the command line overrides it
+    std::string fileName("../param.in");
+    bool fileGiven(false);
+    for(int i(1) ; i < argc ; ++i){
+        std::string argument(argv[i]);
+        if(argument == "--config" and i+1 < argc){
+            fileName = argv[i+1];
+            fileGiven = true;
+        }
+        else if(argument.compare(0, 9, "--config=") == 0){
+            fileName = argument.substr(9);
+            fileGiven = true;
+        }
+    }
+
+    //The default file is optional, all the parameters can be given on the command line
+    if(fileGiven or std::ifstream(fileName).good())
+        config.loadFile(fileName);
+
+    config.parseArguments(argc, argv);
+    config.validate();
+
+    return config;
+}
+
+std::string SimulationConfig::getUsage(){
+
+    return "Usage : Neuron [--config file] [--g value] [--eta value] [--neurons nb] [--start ms] [--stop ms] [--seed seed] [--threads nb] [--output file]\n"
+           "               [--precision double|float|mixed] [--spike-counters 0|1] [--delivery push|pull|auto] [--pull-threshold fraction]\n"
+           "               [--connectivity-seed seed] [--connectivity-cache directory] [--procedural-connectivity 0|1] [--compact-connectivity 0|1]\n"
+           "               [--statistics file] [--bin ms] [--checkpoint file] [--restore file] [--profile file]\n"
+           "               [--h ms] [--delay ms] [--Je mV] [--tau ms] [--epsilon value]\n"
+           "               [--sweep-g g1,g2,...] [--sweep-eta eta1,eta2,...] [--sweep-jobs nb] [--sweep-spikes 0|1] [--summary file]\n"
+           "The config file (../param.in by default) contains one \"key = value\" per line, with the same keys. The command line overrides it.\n"
+           "An empty output (--output=) doesn't write the spikes, the statistics can still be computed.\n";
+}
+
+/*********************************************************************/
+
+std::vector<double> SimulationConfig::toList(std::string const& value, std::string const& key, std::string const& origin){
+
+    std::vector<double> list;
+    std::istringstream values(value);
+    std::string number;
+    while(std::getline(values, number, ','))
+        list.push_back(toNumber(trim(number), key, origin));
+    return list;
+}
+
+unsigned long int SimulationConfig::toSeed(std::string const& value, std::string const& key, std::string const& origin){
+
+    char* end(nullptr);
+    errno = 0;
+    unsigned long int seed(std::strtoul(value.c_str(), &end, 10));
+    if(value.empty() or value[0] == '-' or *end != '\0' or errno != 0)
+        throw(std::string("Invalid argument: ") + key + " must be a positive integer, not \"" + value + "\" (" + origin + ")");
+    return seed;
+}
+
+void SimulationConfig::set(std::string const& key, std::string const& value, std::string const& origin){
+
+    origins_[key] = origin;
+    if(key == "output"){
+        output_ = value;
+        return;
+    }
+    if(key == "checkpoint"){
+        checkpoint_ = value;
+        return;
+    }
+    if(key == "restore"){
+        restore_ = value;
+        return;
+    }
+    if(key == "statistics"){
+        statistics_ = value;
+        return;
+    }
+    if(key == "profile"){
+        profile_ = value;
+        return;
+    }
+    if(key == "summary"){
+        summary_ = value;
+        return;
+    }
+    if(key == "sweep-g"){
+        sweepG_ = toList(value, key, origin);
+        return;
+    }
+    if(key == "sweep-eta"){
+        sweepEta_ = toList(value, key, origin);
+        return;
+    }
+    if(key == "seed"){
+        seed_ = toSeed(value, key, origin);
+        hasSeed_ = true;
+        return;
+    }
+    if(key == "connectivity-seed"){
+        connectivitySeed_ = toSeed(value, key, origin);
+        hasConnectivitySeed_ = true;
+        return;
+    }
+    if(key == "connectivity-cache"){
+        connectivityCache_ = value;
+        return;
+    }
+    if(key == "precision"){
+        precision_ = value;
+        return;
+    }
+    if(key == "delivery"){
+        delivery_ = value;
+        return;
+    }
+
+    double number(toNumber(value, key, origin));
+
+    if(key == "g")
+        g_ = number;
+    else if(key == "eta")
+        eta_ = number;
+    else if(key == "neurons")
+        nbNeurons_ = number;
+    else if(key == "start")
+        start_ = number;
+    else if(key == "stop")
+        stop_ = number;
+    else if(key == "threads")
+        nbThreads_ = number;
+    else if(key == "spike-counters")
+        spikeCounters_ = (number != 0);
+    else if(key == "procedural-connectivity")
+        proceduralConnectivity_ = (number != 0);
+    else if(key == "compact-connectivity")
+        compactConnectivity_ = (number != 0);
+    else if(key == "pull-threshold")
+        pullThreshold_ = number;
+    else if(key == "h")
+        h_ = number;
+    else if(key == "delay")
+        delay_ = number;
+    else if(key == "Je")
+        Je_ = number;
+    else if(key == "tau")
+        tau_ = number;
+    else if(key == "epsilon")
+        epsilon_ = number;
+    else if(key == "bin")
+        bin_ = number;
+    else if(key == "sweep-jobs")
+        sweepJobs_ = number;
+    else if(key == "sweep-spikes")
+        sweepSpikes_ = (number != 0);
+    else
+        throw(std::string("Invalid argument: unknown parameter \"") + key + "\" (" + origin + ")");
+}
+
+void SimulationConfig::load(std::istream& in, std::string const& name){
+
+    std::string line;
+    size_t lineNumber(0), nbPositional(0);
+
+    while(std::getline(in, line)){
+        ++lineNumber;
+        std::string origin(name + " line " + std::to_string(lineNumber));
+
+        //Removes the comment
+        line = trim(line.substr(0, line.find('#')));
+        if(line.empty())
+            continue;
+
+        size_t equal(line.find('='));
+        if(equal != std::string::npos){
+            set(trim(line.substr(0, equal)), trim(line.substr(equal + 1)), origin);
+            continue;
+        }
+
+        //Old format : values without keys, in the order of positionalKeys
+        std::istringstream values(line);
+        std::string value;
+        while(values >> value){
+            if(nbPositional >= sizeof(positionalKeys)/sizeof(positionalKeys[0]))
+                throw(std::string("Invalid argument: too many values without key (") + origin + ")");
+            set(positionalKeys[nbPositional], value, origin);
+            ++nbPositional;
+        }
+    }
+}
+
+void SimulationConfig::loadFile(std::string const& fileName){
+
+    std::ifstream file(fileName);
+    if(file.fail())
+        throw(std::string("Impossible to open the config file ") + fileName);
+
+    load(file, fileName);
+}
+
+void SimulationConfig::parseArguments(int argc, const char* const argv[]){
+
+    for(int i(1) ; i < argc ; ++i){
+        std::string argument(argv[i]);
+        if(argument.compare(0, 2, "--") != 0 or argument.size() == 2)
+            throw(std::string("Invalid argument: \"") + argument + "\" is not an option\n" + getUsage());
+
+        std::string key(argument.substr(2)), value;
+        size_t equal(key.find('='));
+        if(equal != std::string::npos){
+            value = key.substr(equal + 1);
+            key = key.substr(0, equal);
+        }
+        else {
+            if(i+1 >= argc)
+                throw(std::string("Invalid argument: --") + key + " needs a value");
+            value = argv[++i];
+        }
+
+        //The config file has already been read by fromCommandLine
+        if(key != "config")
+            set(key, value, "command line");
+    }
+}
+
+void SimulationConfig::validate() const{
+
+    std::string error("Invalid argument: ");
+
+    if(g_ < 0)
+        throw(error + "G must be a positive real number");
+    if(eta_ < 0)
+        throw(error + "Eta must be a positive real number");
+    if(nbNeurons_ < 0 or !isInteger(nbNeurons_))
+        throw(error + "The number of neurons must be a positive integer number");
+    //Same minimum as the old reading of param.in
+    if(nbNeurons_ < 50)
+        throw(error + "Not enough neurons in the simulation for the chosen ration 0.8:0.2 excitatory:inhibitory. At least 50.");
+    if(start_ < 0)
+        throw(error + "The start time must be a positive number");
+    if(stop_ <= start_)
+        throw(error + "The stop time must be bigger than the start time.");
+    if(nbThreads_ < 1 or !isInteger(nbThreads_))
+        throw(error + "The number of threads must be a positive integer");
+    if(nbThreads_ > nbNeurons_)
+        throw(error + "The number of threads can't be bigger than the number of neurons");
+    if(bin_ <= 0)
+        throw(error + "The duration of a bin must be a strictly positive number");
+    if(precision_ != DoublePrecision::getName() and precision_ != SinglePrecision::getName() and precision_ != MixedPrecision::getName())
+        throw(error + "The precision must be double, float or mixed");
+    //Throws if the name is not a mode
+    SpikeGather::getMode(delivery_);
+    if(pullThreshold_ < 0 or pullThreshold_ > 1)
+        throw(error + "The pull threshold must be in [0, 1]");
+    if(proceduralConnectivity_ and SpikeGather::getMode(delivery_) == SpikeGather::Pull)
+        throw(error + "The procedural connections can't be pulled, they have no list of sources");
+    if(compactConnectivity_ and SpikeGather::getMode(delivery_) == SpikeGather::Pull)
+        throw(error + "The compact connections can't be pulled, they have no list of sources");
+    if(compactConnectivity_ and proceduralConnectivity_)
+        throw(error + "The connections can't be both procedural and compact");
+
+    if(h_ <= 0)
+        throw(error + "h must be a strictly positive number");
+    //The spikes are delivered at least one timeStep later
+    if(delay_ <= 0)
+        throw(error + "The delay must be a strictly positive number");
+    if(Je_ <= 0)
+        throw(error + "Je must be a strictly positive number");
+    if(tau_ <= 0)
+        throw(error + "Tau must be a strictly positive number");
+    if(epsilon_ <= 0 or epsilon_ > 1)
+        throw(error + "Epsilon must be in ]0, 1]");
+    //Each neuron has to receive at least one inhibitory connection
+    if(epsilon_*0.2*nbNeurons_ < 1)
+        throw(error + "Epsilon is too small for this number of neurons, each neuron has no inhibitory connection");
+    //The counters of 16 bits hold the excitatory connections and the background noise of a timeStep, with a margin for the noise
+    if(spikeCounters_ and ceil(epsilon_*0.8*nbNeurons_) > 60000)
+        throw(error + "Too many excitatory connections per neuron for the spike counters (at most 60000)");
+
+    for(auto g : sweepG_){
+        if(g < 0)
+            throw(error + "The values of sweep-g must be positive real numbers");
+    }
+    for(auto eta : sweepEta_){
+        if(eta < 0)
+            throw(error + "The values of sweep-eta must be positive real numbers");
+    }
+    if(sweepJobs_ < 1 or !isInteger(sweepJobs_))
+        throw(error + "The number of sweep jobs must be a positive integer");
+    if(isSweep() and !(checkpoint_.empty() and restore_.empty()))
+        throw(error + "A parameter sweep can't be saved in or restored from a checkpoint");
+    //Each point would encode its own copy of the connections, the stored ones are shared by all the points
+    if(isSweep() and compactConnectivity_)
+        throw(error + "The compact connections can't be shared by the points of a parameter sweep");
+    if(isSweep() and sweepSpikes_ and output_.empty())
+        throw(error + "The name of the output file can't be empty to write the spikes of the sweep");
+    if(isSweep() and summary_.empty())
+        throw(error + "The name of the summary file can't be empty");
+}
+
+/*********************************************************************/
+
+double SimulationConfig::getG() const{
+
+    return g_;
+}
+
+double SimulationConfig::getEta() const{
+
+    return eta_;
+}
+
+unsigned long int SimulationConfig::getNbNeurons() const{
+
+    return nbNeurons_;
+}
+
+double SimulationConfig::getStart() const{
+
+    return start_;
+}
+
+double SimulationConfig::getStop() const{
+
+    return stop_;
+}
+
+bool SimulationConfig::hasSeed() const{
+
+    return hasSeed_;
+}
+
+unsigned long int SimulationConfig::getSeed() const{
+
+    return seed_;
+}
+
+bool SimulationConfig::hasConnectivitySeed() const{
+
+    return hasConnectivitySeed_;
+}
+
+unsigned long int SimulationConfig::getConnectivitySeed() const{
+
+    return connectivitySeed_;
+}
+
+std::string const& SimulationConfig::getConnectivityCache() const{
+
+    return connectivityCache_;
+}
+
+unsigned int SimulationConfig::getNbThreads() const{
+
+    return nbThreads_;
+}
+
+bool SimulationConfig::getSpikeCounters() const{
+
+    return spikeCounters_;
+}
+
+bool SimulationConfig::getProceduralConnectivity() const{
+
+    return proceduralConnectivity_;
+}
+
+bool SimulationConfig::getCompactConnectivity() const{
+
+    return compactConnectivity_;
+}
+
+std::string const& SimulationConfig::getPrecision() const{
+
+    return precision_;
+}
+
+SpikeGather::Mode SimulationConfig::getDelivery() const{
+
+    return SpikeGather::getMode(delivery_);
+}
+
+double SimulationConfig::getPullThreshold() const{
+
+    return pullThreshold_;
+}
+
+std::string const& SimulationConfig::getOutput() const{
+
+    return output_;
+}
+
+std::string const& SimulationConfig::getCheckpoint() const{
+
+    return checkpoint_;
+}
+
+std::string const& SimulationConfig::getRestore() const{
+
+    return restore_;
+}
+
+std::string const& SimulationConfig::getStatistics() const{
+
+    return statistics_;
+}
+
+std::string const& SimulationConfig::getProfile() const{
+
+    return profile_;
+}
+
+unsigned long int SimulationConfig::getBinSteps() const{
+
+    //A bin contains at least one timeStep
+    return std::max(1L, std::lround(bin_/h_));
+}
+
+PhysicsParameters SimulationConfig::getPhysics() const{
+
+    return PhysicsParameters(h_, delay_, Je_, tau_, epsilon_);
+}
+
+bool SimulationConfig::isSweep() const{
+
+    return !sweepG_.empty() or !sweepEta_.empty();
+}
+
+std::vector<double> SimulationConfig::getSweepG() const{
+
+    return sweepG_.empty() ? std::vector<double>(1, g_) : sweepG_;
+}
+
+std::vector<double> SimulationConfig::getSweepEta() const{
+
+    return sweepEta_.empty() ? std::vector<double>(1, eta_) : sweepEta_;
+}
+
+unsigned int SimulationConfig::getSweepJobs() const{
+
+    return sweepJobs_;
+}
+
+bool SimulationConfig::getSweepSpikes() const{
+
+    return sweepSpikes_;
+}
+
+std::string const& SimulationConfig::getSummary() const{
+
+    return summary_;
+}
+
+std::string SimulationConfig::getOrigin(std::string const& key) const{
+
+    auto origin(origins_.find(key));
+    return origin == origins_.end() ? std::string() : origin->second;
+}
@@ -0,0 +1,284 @@
+#ifndef SIMULATION_CONFIG_H
+#define SIMULATION_CONFIG_H
+
+#include <string>
+#include <istream>
+#include <vector>
+#include <map>
+#include "physicsParameters.hpp"
+#include "spikeGather.hpp"
+
+
+//!  Class SimulationConfig
+/*!
+ This class contains all the parameters of a simulation, so that they can be changed without compiling again.
+
+ The parameters are read from a config file with one "key = value" per line ('#' begins a comment), then from the command line with "--key value" or "--key=value", which overrides the file. The keys are :
+ g, eta, neurons, start, stop (in [ms]), seed (of the background noise, random if not given), connectivity-seed (of the connections, random if not given), connectivity-cache (directory where the connections are kept between the runs, see ConnectivityCache), procedural-connectivity (1 to compute the targets of each neuron when it spikes instead of storing them, see ProceduralConnectivity), compact-connectivity (1 to store the targets of each neuron as differences of 16 bits, see CompactConnectivity), threads, spike-counters (1 to count the excitatory and the inhibitory spikes in 16 bits instead of summing them in buffers, see NeuronPopulation), delivery (push, pull or auto, see SpikeGather), pull-threshold (fraction of the neurons spiking in a timeStep above which the automatic delivery pulls the spikes, 1 by default), precision (double, float or mixed, see PrecisionPolicy), output (the binary file of the spikes, nothing is written if it is empty), statistics (the summary file of SpikeStatistics, not computed if it is empty), bin (the bins of the histogram in [ms]), checkpoint (file where the state is saved at the end), profile (JSON file of the time of each phase of the run, see RunProfile), restore (checkpoint the simulation continues from, its parameters replace the ones of the config except seed, a different value on the command line is rejected), and the physical parameters h, delay, Je, tau, epsilon.
+ A parameter sweep over a grid of (g, eta) is described by the keys sweep-g and sweep-eta (lists of values separated by commas, the value of g or eta if one of them is not given), sweep-jobs (number of points simulated at the same time), sweep-spikes (1 to write the spikes of each point) and summary (file of the results of the points).
+ The old format of param.in (g, eta, the number of neurons, the start time, the stop time and optionally the number of threads, separated by spaces or new lines) is still accepted.
+
+ All the parameters are validated at once, before the creation of the network : an invalid parameter throws a std::string describing the error.
+ */
+
+class SimulationConfig{
+
+    private:
+
+    double g_; //!< Ratio Ji/Je
+    double eta_; //!< Ratio Vext/Vthr
+    double nbNeurons_; //!< Number of neurons of the network
+    double start_; //!< Beginning of the recording of the spikes in [ms]
+    double stop_; //!< End of the simulation in [ms]
+    bool hasSeed_; //!< True if the seed of the background noise is given
+    unsigned long int seed_; //!< Seed of the background noise, if hasSeed_
+    bool hasConnectivitySeed_; //!< True if the seed of the connections is given
+    unsigned long int connectivitySeed_; //!< Seed of the connections, if hasConnectivitySeed_
+    std::string connectivityCache_; //!< Directory of the cache of the connections, empty if they are always generated
+    double nbThreads_; //!< Number of threads that update the network
+    bool spikeCounters_; //!< True if the neurons count the spikes of each type instead of summing them in buffers
+    bool proceduralConnectivity_; //!< True if the targets of each neuron are computed when it spikes instead of being stored
+    bool compactConnectivity_; //!< True if the targets of each neuron are stored as differences of 16 bits
+    std::string delivery_; //!< Name of the mode of delivery of the spikes : "push", "pull" or "auto"
+    double pullThreshold_; //!< Fraction of the neurons that have to spike in a timeStep for the automatic delivery to pull the spikes (see SpikeGather::setPullThreshold)
+    std::string precision_; //!< Name of the PrecisionPolicy of the neurons : "double" (the reference), "float" or "mixed"
+    std::string output_; //!< Name of the binary file of the spikes, empty if the spikes are not written
+    std::string statistics_; //!< Name of the summary file of the statistics of the spikes, empty if they are not computed
+    double bin_; //!< Duration of a bin of the histogram of the statistics in [ms]
+    std::string checkpoint_; //!< Name of the checkpoint file written at the end of the simulation, empty if none
+    std::string restore_; //!< Name of the checkpoint file the simulation begins from, empty to create a new network
+    std::string profile_; //!< Name of the JSON file of the profile of the run (see RunProfile), empty if it is not written
+
+    double h_; //!< Duration of a timeStep in [ms]
+    double delay_; //!< Delay of the connections in [ms]
+    double Je_; //!< Amplitude of an excitatory spike in [mV]
+    double tau_; //!< Time constant of the membrane in [ms]
+    double epsilon_; //!< Ratio of connections
+
+    std::vector<double> sweepG_; //!< Values of g of the sweep, empty if g_ is the only one
+    std::vector<double> sweepEta_; //!< Values of eta of the sweep, empty if eta_ is the only one
+    double sweepJobs_; //!< Number of points of the sweep simulated at the same time
+    bool sweepSpikes_; //!< True if the spikes of each point of the sweep are written in a file
+    std::map<std::string, std::string> origins_; //!< Where each key given was read the last time : "command line", or the name of the config file and the line
+    std::string summary_; //!< Name of the file of the results of the sweep
+
+
+    /*********************************************************************/
+
+    /**
+     * Reads a list of numbers separated by commas
+     * @param value is the list, as written in the file or on the command line
+     * @param key is the name of the parameter, for the error messages
+     * @param origin is the place where the value was read, for the error messages
+     * @return the numbers
+     * @throw std::string if a value is not a number
+     */
+    static std::vector<double> toList(std::string const& value, std::string const& key, std::string const& origin);
+
+    /**
+     * Reads a seed
+     * @param value is the seed, as written in the file or on the command line
+     * @param key is the name of the parameter, for the error messages
+     * @param origin is the place where the value was read, for the error messages
+     * @return the seed
+     * @throw std::string if the value is not a positive integer
+     */
+    static unsigned long int toSeed(std::string const& value, std::string const& key, std::string const& origin);
+
+    /**
+     * Changes the value of one parameter
+     * @param key is the name of the parameter
+     * @param value is its new value, as written in the file or on the command line
+     * @param origin is the place where the value was read, for the error messages
+     * @throw std::string if the key is unknown or the value is not a number
+     */
+    void set(std::string const& key, std::string const& value, std::string const& origin);
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Constructor with the default parameters : the ones of param.in and of Utility/Constants.h, 1 thread, a random seed and ../result/spikes.bin
+     */
+    SimulationConfig();
+
+    /**
+     * Reads the parameters of a config file from the file ../param.in (optional) or the one given with --config, then the ones of the command line, and validates them
+     * @param argc is the number of arguments of the command line
+     * @param argv are the arguments of the command line, argv[0] is the name of the program
+     * @return the config
+     * @throw std::string if a parameter is invalid
+     */
+    static SimulationConfig fromCommandLine(int argc, const char* const argv[]);
+
+    /**
+     * @return the description of the options of the command line
+     */
+    static std::string getUsage();
+
+    /*********************************************************************/
+
+    /**
+     * Reads the parameters of a config file, keyed or in the old positional format
+     * @param in is the stream of the file
+     * @param name is the name of the file, for the error messages
+     * @throw std::string if a line can't be read
+     */
+    void load(std::istream& in, std::string const& name);
+    /**
+     * Reads the parameters of a config file
+     * @param fileName is the name of the file
+     * @throw std::string if the file can't be opened or read
+     */
+    void loadFile(std::string const& fileName);
+
+    /**
+     * Reads the parameters of the command line, they override the ones already read. --config is ignored (see fromCommandLine)
+     * @param argc is the number of arguments
+     * @param argv are the arguments, argv[0] is the name of the program
+     * @throw std::string if an option is unknown or has no value
+     */
+    void parseArguments(int argc, const char* const argv[]);
+
+    /**
+     * Checks all the parameters together
+     * @throw std::string describing the first invalid parameter
+     */
+    void validate() const;
+
+    /*********************************************************************/
+
+    /**
+     * @return g_
+     */
+    double getG() const;
+    /**
+     * @return eta_
+     */
+    double getEta() const;
+    /**
+     * @return nbNeurons_
+     */
+    unsigned long int getNbNeurons() const;
+    /**
+     * @return start_
+     */
+    double getStart() const;
+    /**
+     * @return stop_
+     */
+    double getStop() const;
+    /**
+     * @return hasSeed_
+     */
+    bool hasSeed() const;
+    /**
+     * @return seed_
+     */
+    unsigned long int getSeed() const;
+    /**
+     * @return hasConnectivitySeed_
+     */
+    bool hasConnectivitySeed() const;
+    /**
+     * @return connectivitySeed_
+     */
+    unsigned long int getConnectivitySeed() const;
+    /**
+     * @return connectivityCache_
+     */
+    std::string const& getConnectivityCache() const;
+    /**
+     * @return nbThreads_
+     */
+    unsigned int getNbThreads() const;
+    /**
+     * @return spikeCounters_
+     */
+    bool getSpikeCounters() const;
+    /**
+     * @return proceduralConnectivity_
+     */
+    bool getProceduralConnectivity() const;
+    /**
+     * @return compactConnectivity_
+     */
+    bool getCompactConnectivity() const;
+    /**
+     * @return precision_
+     */
+    std::string const& getPrecision() const;
+    /**
+     * @return the mode of delivery of the spikes, valid once the config is validated
+     */
+    SpikeGather::Mode getDelivery() const;
+    /**
+     * @return pullThreshold_
+     */
+    double getPullThreshold() const;
+    /**
+     * @return output_
+     */
+    std::string const& getOutput() const;
+    /**
+     * @return checkpoint_
+     */
+    std::string const& getCheckpoint() const;
+    /**
+     * @return restore_
+     */
+    std::string const& getRestore() const;
+    /**
+     * @return statistics_
+     */
+    std::string const& getStatistics() const;
+    /**
+     * @return profile_
+     */
+    std::string const& getProfile() const;
+    /**
+     * @return the number of timeSteps per bin of the histogram of the statistics (at least 1)
+     */
+    unsigned long int getBinSteps() const;
+    /**
+     * @return the physical parameters (h, delay, Je, tau, epsilon), which have to be valid
+     */
+    PhysicsParameters getPhysics() const;
+
+    /**
+     * @return true if sweep-g or sweep-eta is given
+     */
+    bool isSweep() const;
+    /**
+     * @return the values of g of the sweep (g_ alone if sweep-g is not given)
+     */
+    std::vector<double> getSweepG() const;
+    /**
+     * @return the values of eta of the sweep (eta_ alone if sweep-eta is not given)
+     */
+    std::vector<double> getSweepEta() const;
+    /**
+     * @return sweepJobs_
+     */
+    unsigned int getSweepJobs() const;
+    /**
+     * @return sweepSpikes_
+     */
+    bool getSweepSpikes() const;
+    /**
+     * @return summary_
+     */
+    std::string const& getSummary() const;
+    /**
+     * @param key is the name of a parameter
+     * @return where the parameter was given the last time ("command line", or the config file and the line), empty if it has its default value
+     */
+    std::string getOrigin(std::string const& key) const;
+
+};
+
+#endif
@@ -0,0 +1,141 @@
+#include "spikeExchange.hpp"
+#include <cassert>
+#ifdef NEURON_MPI
+#include <mpi.h>
+#endif
+
+SpikeExchange::SpikeExchange()
+: SpikeExchange(0, 1)
+{}
+
+SpikeExchange::SpikeExchange(int const& rank, int const& nbProcesses)
+: rank_(rank), nbProcesses_(nbProcesses), counts_(nbProcesses, 0), displacements_(nbProcesses, 0)
+{
+    assert(nbProcesses_ > 0);
+    assert(rank_ >= 0 and rank_ < nbProcesses_);
+}
+
+SpikeExchange SpikeExchange::world(){
+
+#ifdef NEURON_MPI
+    int rank(0), nbProcesses(1);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nbProcesses);
+    return SpikeExchange(rank, nbProcesses);
+#else
+    throw(std::string("The distributed simulation needs MPI, compile with cmake -DNEURON_MPI=ON"));
+#endif
+}
+
+bool SpikeExchange::isAvailable(){
+
+#ifdef NEURON_MPI
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::string SpikeExchange::getRankFileName(std::string const& fileName, int const& rank){
+
+    if(fileName.empty())
+        return fileName;
+    return fileName + "." + std::to_string(rank);
+}
+
+int SpikeExchange::getRank() const{
+
+    return rank_;
+}
+
+int SpikeExchange::getNbProcesses() const{
+
+    return nbProcesses_;
+}
+
+bool SpikeExchange::isDistributed() const{
+
+    return nbProcesses_ > 1;
+}
+
+/*********************************************************************/
+
+void SpikeExchange::exchange(std::vector< std::vector< std::vector<uint32_t> > >::iterator windowSpikes, size_t const& nbSteps, size_t const& nbRanges){
+
+    if(!isDistributed())
+        return;
+
+#ifdef NEURON_MPI
+    //For each timeStep, the number of spikes of the ranges of this process then their neurons, range after range
+    sendBuffer_.clear();
+    for(size_t step(0) ; step < nbSteps ; ++step){
+        size_t position(sendBuffer_.size());
+        sendBuffer_.push_back(0);
+        for(size_t range(rank_*nbRanges) ; range < (rank_+1)*nbRanges ; ++range)
+            sendBuffer_.insert(sendBuffer_.end(), windowSpikes[step][range].begin(), windowSpikes[step][range].end());
+        sendBuffer_[position] = sendBuffer_.size() - position - 1;
+    }
+
+    int count(sendBuffer_.size());
+    MPI_Allgather(&count, 1, MPI_INT, counts_.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    int size(0);
+    for(int process(0) ; process < nbProcesses_ ; ++process){
+        displacements_[process] = size;
+        size += counts_[process];
+    }
+    receiveBuffer_.resize(size);
+    MPI_Allgatherv(sendBuffer_.data(), count, MPI_UINT32_T, receiveBuffer_.data(), counts_.data(), displacements_.data(), MPI_UINT32_T, MPI_COMM_WORLD);
+
+    //The spikes of the other processes are put in the list of their first range, the lists of their other ranges stay empty
+    for(int process(0) ; process < nbProcesses_ ; ++process){
+        if(process == rank_)
+            continue;
+        const uint32_t* spikes(receiveBuffer_.data() + displacements_[process]);
+        for(size_t step(0) ; step < nbSteps ; ++step){
+            uint32_t nb(*spikes++);
+            windowSpikes[step][process*nbRanges].assign(spikes, spikes + nb);
+            spikes += nb;
+            for(size_t range(process*nbRanges + 1) ; range < (process+1)*nbRanges ; ++range)
+                windowSpikes[step][range].clear();
+        }
+        assert(spikes == receiveBuffer_.data() + displacements_[process] + counts_[process]);
+    }
+#else
+    (void)windowSpikes;
+    (void)nbSteps;
+    (void)nbRanges;
+    assert(false);
+#endif
+}
+
+unsigned long int SpikeExchange::sum(unsigned long int const& value) const{
+
+#ifdef NEURON_MPI
+    if(isDistributed()){
+        unsigned long int total(0);
+        MPI_Allreduce(&value, &total, 1, MPI_UNSIGNED_LONG, MPI_SUM, MPI_COMM_WORLD);
+        return total;
+    }
+#endif
+    return value;
+}
+
+void SpikeExchange::sum(std::vector<uint32_t>& values) const{
+
+#ifdef NEURON_MPI
+    if(isDistributed())
+        MPI_Allreduce(MPI_IN_PLACE, values.data(), values.size(), MPI_UINT32_T, MPI_SUM, MPI_COMM_WORLD);
+#else
+    (void)values;
+#endif
+}
+
+void SpikeExchange::sum(std::vector<double>& values) const{
+
+#ifdef NEURON_MPI
+    if(isDistributed())
+        MPI_Allreduce(MPI_IN_PLACE, values.data(), values.size(), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+#else
+    (void)values;
+#endif
+}
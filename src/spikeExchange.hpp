@@ -0,0 +1,105 @@
+#ifndef SPIKE_EXCHANGE_H
+#define SPIKE_EXCHANGE_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+
+//!  Class SpikeExchange
+/*!
+ This class connects the processes of a distributed simulation (MPI, compiled with NEURON_MPI) : each process updates a contiguous part of the ranges of neurons of the network, and only holds the connections that reach its neurons.
+ All the connections have the same delay, so the processes only need the spikes of the others once per window of timeSteps (see Network::getWindowSteps) : the spikes of the ranges of each process during the window are exchanged with one MPI_Allgatherv (after an MPI_Allgather of their sizes).
+
+ The spikes of another process are put in the list of its first range, in the order of its ranges : every process delivers the spikes in the same order as a single process with as many threads as the ranges of all the processes, which gives the same spikes.
+ Without MPI, the exchange is the one of a single process, which has nothing to exchange. A process of a larger run can still be created (to build its part of the network in the tests) but not updated.
+ */
+
+class SpikeExchange{
+
+    private:
+
+    int rank_; //!< Index of the process, from 0 to nbProcesses_-1
+    int nbProcesses_; //!< Number of processes of the simulation
+    std::vector<uint32_t> sendBuffer_; //!< Spikes of the ranges of this process during a window : for each timeStep, its number of spikes then the neurons
+    std::vector<uint32_t> receiveBuffer_; //!< Spikes of the ranges of all the processes during a window, one sendBuffer_ after the other
+    std::vector<int> counts_; //!< Size of the sendBuffer_ of each process
+    std::vector<int> displacements_; //!< Position of the sendBuffer_ of each process in receiveBuffer_
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Constructor of the exchange of a simulation in a single process
+     */
+    SpikeExchange();
+    /**
+     * Constructor of one process of a distributed simulation
+     * @param rank is the index of the process
+     * @param nbProcesses is the number of processes
+     */
+    SpikeExchange(int const& rank, int const& nbProcesses);
+
+    /**
+     * @return the exchange between all the processes of MPI_COMM_WORLD, MPI being initialised
+     * @throw std::string if the program is compiled without MPI
+     */
+    static SpikeExchange world();
+    /**
+     * @return true if the program is compiled with MPI (NEURON_MPI)
+     */
+    static bool isAvailable();
+    /**
+     * @param fileName is the name of the file of a single process
+     * @param rank is the index of a process
+     * @return the name of the file of the process : fileName followed by "." and the rank, empty if fileName is empty
+     */
+    static std::string getRankFileName(std::string const& fileName, int const& rank);
+
+    /**
+     * @return rank_
+     */
+    int getRank() const;
+    /**
+     * @return nbProcesses_
+     */
+    int getNbProcesses() const;
+    /**
+     * @return true if the simulation has more than one process
+     */
+    bool isDistributed() const;
+
+    /*********************************************************************/
+
+    /**
+     * Exchanges the spikes of a window with the other processes : the lists of the ranges of this process are sent, the lists of the others are received in the list of their first range
+     * @param windowSpikes are the lists of the spikes of each range, for each timeStep of the window
+     * @param nbSteps is the number of timeSteps of the window
+     * @param nbRanges is the number of ranges of each process
+     */
+    void exchange(std::vector< std::vector< std::vector<uint32_t> > >::iterator windowSpikes, size_t const& nbSteps, size_t const& nbRanges);
+
+    /**
+     * @param value is a number of this process
+     * @return the sum of the numbers of all the processes
+     */
+    unsigned long int sum(unsigned long int const& value) const;
+    /**
+     * Sums arrays element by element over all the processes, which all have to call it with arrays of the same size
+     * @param values is the array of this process, replaced by the sum of the arrays of all the processes
+     */
+    void sum(std::vector<uint32_t>& values) const;
+    /**
+     * Sums arrays element by element over all the processes, which all have to call it with arrays of the same size
+     * @param values is the array of this process, replaced by the sum of the arrays of all the processes
+     */
+    void sum(std::vector<double>& values) const;
+
+};
+
+#endif
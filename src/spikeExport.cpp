@@ -0,0 +1,44 @@
+#include "spikeRecorder.hpp"
+#include <iostream>
+
+using namespace std;
+
+/**
+ * Converts a binary spike file written by the simulation into the text format read by plotA.py and plotB_C_D.py : one line "step id" per spike
+ * Usage : SpikeExport [binary file (../result/spikes.bin)] [text file (../result/spikes)]
+ */
+int main(int argc, char* argv[]){
+
+    string input("../result/spikes.bin"), output("../result/spikes");
+    if(argc > 1)
+        input = argv[1];
+    if(argc > 2)
+        output = argv[2];
+
+    try{
+        SpikeReader reader(input);
+
+        ofstream text(output);
+        if(text.fail())
+            throw(string("Impossible to open the text file ") + output);
+
+        SpikeFileHeader const& header(reader.getHeader());
+        cout << "h=" << header.h << " N=" << header.nbNeurons << " g=" << header.g << " eta=" << header.eta << " seed=" << header.seed << " connectivity-seed=" << header.connectivitySeed << endl;
+
+        //The stream is flushed only at the end, not at each spike
+        unsigned long int nbSpikes(0);
+        SpikeRecord spike;
+        while(reader.next(spike)){
+            text << spike.step << " " << spike.neuron << '\n';
+            ++nbSpikes;
+        }
+
+        cout << nbSpikes << " spikes written in " << output << endl;
+    }
+    catch(string errorMsg){
+        cerr << errorMsg << endl;
+        return 1;
+    }
+
+    return 0;
+}
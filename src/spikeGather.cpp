@@ -0,0 +1,114 @@
+#include "spikeGather.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <thread>
+
+SpikeGather::SpikeGather()
+: nbExcitatory_(0), targetsOf_(nullptr), pullThreshold_(1)
+{}
+
+std::string SpikeGather::getName(Mode const& mode){
+
+    switch(mode){
+        case Push:
+            return "push";
+        case Pull:
+            return "pull";
+        case Automatic:
+            return "auto";
+        default:
+            return "";
+    }
+}
+
+SpikeGather::Mode SpikeGather::getMode(std::string const& name){
+
+    for(Mode mode : {Push, Pull, Automatic}){
+        if(name == getName(mode))
+            return mode;
+    }
+    throw(std::string("Invalid argument: The delivery must be push, pull or auto, not \"") + name + "\"");
+}
+
+void SpikeGather::prepare(Connectivity const& targets, unsigned long int const& nbExcitatory, unsigned int const& nbThreads){
+
+    //The sources are only transposed again if the connections have changed
+    const uint32_t* targetsOf(targets.size() > 0 ? targets[0].begin() : nullptr);
+    if(sources_.size() != targets.size() or sources_.getNbSynapses() != targets.getNbSynapses() or targetsOf_ != targetsOf){
+        sources_ = targets.transpose(targets.size(), std::max(1u, std::thread::hardware_concurrency()));
+        targetsOf_ = targetsOf;
+    }
+    nbExcitatory_ = nbExcitatory;
+
+    //One bit per neuron, rounded up to a word
+    bitsets_.assign(nbThreads, std::vector<uint64_t>((targets.size() + 63)/64, 0));
+}
+
+void SpikeGather::reset(){
+
+    sources_ = Connectivity();
+    targetsOf_ = nullptr;
+}
+
+Connectivity const& SpikeGather::getSources() const{
+
+    return sources_;
+}
+
+double SpikeGather::getPullThreshold() const{
+
+    return pullThreshold_;
+}
+
+void SpikeGather::setPullThreshold(double const& fraction){
+
+    assert(fraction >= 0);
+    pullThreshold_ = fraction;
+}
+
+bool SpikeGather::isPullPossible() const{
+
+    //There can't be more spikes than neurons in a timeStep
+    return pullThreshold_ < 1;
+}
+
+bool SpikeGather::isPullFaster(size_t const& nbSpikes, size_t const& nbNeurons) const{
+
+    //The push delivery costs nbSpikes*K writes, the pull delivery nbNeurons*K reads of the bitset (K connections per neuron)
+    return nbSpikes > pullThreshold_*nbNeurons;
+}
+
+/*********************************************************************/
+
+void SpikeGather::markSpikes(size_t const& thread, std::vector< std::vector<uint32_t> > const& spiking){
+
+    assert(thread < bitsets_.size());
+    std::vector<uint64_t>& bitset(bitsets_[thread]);
+    std::memset(bitset.data(), 0, bitset.size()*sizeof(uint64_t));
+
+    for(auto const& range : spiking){
+        for(auto neuron : range)
+            bitset[neuron >> 6] |= uint64_t(1) << (neuron & 63);
+    }
+}
+
+void SpikeGather::countSpikes(size_t const& thread, size_t const& target, uint32_t& nbExcitatory, uint32_t& nbInhibitory) const{
+
+    const uint64_t* bitset(bitsets_[thread].data());
+    Connectivity::TargetRange sources(sources_[target]);
+
+    //The sources are sorted, the excitatory ones first
+    const uint32_t* firstInhibitory(std::lower_bound(sources.begin(), sources.end(), nbExcitatory_));
+
+    //Without branches : the bit of each source is added
+    uint32_t nb(0);
+    for(const uint32_t* source(sources.begin()) ; source != firstInhibitory ; ++source)
+        nb += (bitset[*source >> 6] >> (*source & 63)) & 1;
+    nbExcitatory = nb;
+
+    nb = 0;
+    for(const uint32_t* source(firstInhibitory) ; source != sources.end() ; ++source)
+        nb += (bitset[*source >> 6] >> (*source & 63)) & 1;
+    nbInhibitory = nb;
+}
@@ -0,0 +1,123 @@
+#ifndef SPIKE_GATHER_H
+#define SPIKE_GATHER_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include "connectivity.hpp"
+
+
+//!  Class SpikeGather
+/*!
+ This class delivers the spikes of a timeStep in the pull mode : instead of each spiking neuron writing in the buffers of its targets (push, random writes), each neuron of a range counts how many of its sources have spiked, reading them in a bitset of the spikes of the timeStep.
+ The sources of each neuron are the transpose of the targets of the network, sorted by increasing index : the excitatory sources come first, and a neuron adds its excitatory spikes then its inhibitory ones in the same order as the push delivery, so that the buffers are bit-identical in the two modes.
+
+ Each thread builds its own bitset from the lists of spikes of all the ranges (a few hundred bits per timeStep), so the threads never write in the same memory.
+ The push delivery costs one write per spike and target, the pull delivery one read of the bitset per connection of the range whatever the activity : the pull mode only pays off when a large part of the neurons spike in the same timeStep. In the automatic mode, the mode of each timeStep is chosen from its number of spikes (see isPullFaster).
+ Measured on one core, a read of the bitset (about 1.5 ns) costs as much as a write of the push delivery (about 1.35 ns) : the pull delivery would need all the neurons to spike in the same timeStep, so the threshold is 1 by default and the automatic mode keeps the push delivery, without transposing the connections. A lower threshold makes sense on machines where the random writes are more expensive (many threads sharing the buffers, remote memory).
+ */
+
+class SpikeGather{
+
+    public:
+
+    //!  Enum Mode
+    /*!
+     The modes of delivery of the spikes
+     */
+    enum Mode{
+        Push, //!< Each spike is written in the buffers of the targets of the source
+        Pull, //!< Each neuron counts its sources that have spiked
+        Automatic //!< The faster of the two, chosen at each timeStep from the number of spikes
+    };
+
+    private:
+
+    Connectivity sources_; //!< The sources of each neuron, sorted by increasing index. Empty until prepare
+    unsigned long int nbExcitatory_; //!< Number of excitatory neurons, the sources lower than it are excitatory
+    const uint32_t* targetsOf_; //!< Address of the targets the sources were transposed from, to know if the connections have changed
+    std::vector< std::vector<uint64_t> > bitsets_; //!< One bitset of the spikes of the timeStep per thread
+    double pullThreshold_; //!< Fraction of the neurons that have to spike in a timeStep for the pull mode to be faster, 1 by default
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Constructor of an empty gather, prepare has to be called before the first delivery
+     */
+    SpikeGather();
+
+    /**
+     * @param mode is a mode of delivery
+     * @return its name ("push", "pull" or "auto")
+     */
+    static std::string getName(Mode const& mode);
+    /**
+     * @param name is the name of a mode ("push", "pull" or "auto")
+     * @return the mode
+     * @throw std::string if the name is not a mode
+     */
+    static Mode getMode(std::string const& name);
+
+    /**
+     * Transposes the targets of the network into the sources of each neuron, if it has not been done for these connections, and creates the bitsets of the threads
+     * @param targets are the targets of each neuron
+     * @param nbExcitatory is the number of excitatory neurons
+     * @param nbThreads is the number of threads of the update
+     */
+    void prepare(Connectivity const& targets, unsigned long int const& nbExcitatory, unsigned int const& nbThreads);
+    /**
+     * Forgets the sources, when the connections of the network change
+     */
+    void reset();
+    /**
+     * @return the sources of each neuron, empty before prepare
+     */
+    Connectivity const& getSources() const;
+
+    /**
+     * @return pullThreshold_
+     */
+    double getPullThreshold() const;
+    /**
+     * Setter of pullThreshold_
+     * @param fraction is the fraction of the neurons that have to spike in a timeStep for the pull mode to be used by the automatic mode
+     */
+    void setPullThreshold(double const& fraction);
+    /**
+     * @return true if the automatic mode can choose the pull delivery (a threshold lower than 1)
+     */
+    bool isPullPossible() const;
+    /**
+     * @param nbSpikes is the number of spikes of a timeStep
+     * @param nbNeurons is the number of neurons of the network
+     * @return true if the pull delivery of these spikes is faster than the push delivery
+     */
+    bool isPullFaster(size_t const& nbSpikes, size_t const& nbNeurons) const;
+
+    /*********************************************************************/
+
+    /**
+     * Writes the spikes of a timeStep in the bitset of a thread, after emptying it
+     * @param thread is the index of the thread
+     * @param spiking are the lists of the neurons that have spiked, one per range
+     */
+    void markSpikes(size_t const& thread, std::vector< std::vector<uint32_t> > const& spiking);
+
+    /**
+     * Counts the sources of a neuron that have spiked, in the bitset of a thread
+     * @param thread is the index of the thread
+     * @param target is the index of the neuron
+     * @param nbExcitatory is set to the number of its excitatory sources that have spiked
+     * @param nbInhibitory is set to the number of its inhibitory sources that have spiked
+     */
+    void countSpikes(size_t const& thread, size_t const& target, uint32_t& nbExcitatory, uint32_t& nbInhibitory) const;
+
+};
+
+#endif
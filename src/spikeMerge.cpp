@@ -0,0 +1,42 @@
+#include "spikeRecorder.hpp"
+#include "spikeExchange.hpp"
+#include <iostream>
+
+using namespace std;
+
+/**
+ * Merges the binary spike files written by the processes of a distributed simulation (file.0, file.1...) into the file of a single process, sorted by timeStep
+ * Usage : SpikeMerge number of processes [binary file (../result/spikes.bin)]
+ */
+int main(int argc, char* argv[]){
+
+    if(argc < 2){
+        cerr << "Usage : SpikeMerge number of processes [binary file (../result/spikes.bin)]" << endl;
+        return 1;
+    }
+
+    int nbProcesses(atoi(argv[1]));
+    string output("../result/spikes.bin");
+    if(argc > 2)
+        output = argv[2];
+    if(nbProcesses <= 0){
+        cerr << "Invalid argument: The number of processes must be positive" << endl;
+        return 1;
+    }
+
+    //The files in the order of the ranks give the spikes of each timeStep in the order of a single process
+    vector<string> inputs;
+    for(int rank(0) ; rank < nbProcesses ; ++rank)
+        inputs.push_back(SpikeExchange::getRankFileName(output, rank));
+
+    try{
+        unsigned long int nbSpikes(SpikeRecorder::merge(inputs, output));
+        cout << nbSpikes << " spikes of " << nbProcesses << " processes written in " << output << endl;
+    }
+    catch(string errorMsg){
+        cerr << errorMsg << endl;
+        return 1;
+    }
+
+    return 0;
+}
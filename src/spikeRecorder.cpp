@@ -0,0 +1,303 @@
+#include "spikeRecorder.hpp"
+#include <cassert>
+#include <cstring>
+#include <chrono>
+#include <iostream>
+
+const char SpikeRecorder::magic[8] = "BRUNSPK";
+const uint32_t SpikeRecorder::version = 2;
+
+namespace {
+
+    /**
+     * Writes the binary representation of a value in a stream
+     * @param out is the stream
+     * @param value is the value to write
+     */
+    template<typename T>
+    void writeValue(std::ostream& out, T const& value){
+
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    /**
+     * Reads the binary representation of a value from a stream
+     * @param in is the stream
+     * @param value receives the value read
+     */
+    template<typename T>
+    void readValue(std::istream& in, T& value){
+
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+
+    /**
+     * @param begin is the beginning of an interval of time
+     * @return the number of seconds since begin
+     */
+    double secondsSince(std::chrono::steady_clock::time_point const& begin){
+
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+}
+
+SpikeRecorder::SpikeRecorder(size_t const& bufferCapacity)
+: bufferCapacity_(bufferCapacity), nbSpikes_(0), asynchronous_(false), closing_(false), statistics_()
+{
+    assert(bufferCapacity_ > 0);
+}
+
+SpikeRecorder::~SpikeRecorder(){
+
+    close();
+}
+
+/*********************************************************************/
+
+void SpikeRecorder::setAsynchronous(bool const& b){
+
+    assert(!isOpen());
+    asynchronous_ = b;
+}
+
+bool SpikeRecorder::getAsynchronous() const{
+
+    return asynchronous_;
+}
+
+void SpikeRecorder::open(std::string const& fileName, SpikeFileHeader const& header){
+
+    close();
+
+    file_.open(fileName, std::ios::binary | std::ios::trunc);
+    assert(!file_.fail());
+    nbSpikes_ = 0;
+    statistics_ = SpikeWriterStatistics();
+
+    //The header, field by field so that it doesn't depend on the padding of the struct
+    file_.write(magic, sizeof(magic));
+    writeValue(file_, version);
+    writeValue(file_, header.h);
+    writeValue(file_, header.nbNeurons);
+    writeValue(file_, header.g);
+    writeValue(file_, header.eta);
+    writeValue(file_, header.seed);
+    writeValue(file_, header.connectivitySeed);
+
+    if(getAsynchronous()){
+        //The I/O thread writes everything after the header
+        queue_.reset(new SpscQueue<SpikeRecord>(bufferCapacity_));
+        closing_ = false;
+        writer_ = std::thread(&SpikeRecorder::writeLoop, this);
+    }
+    else {
+        buffer_.reserve(bufferCapacity_);
+    }
+}
+
+void SpikeRecorder::close(){
+
+    if(!isOpen())
+        return;
+
+    if(writer_.joinable()){
+        //The I/O thread writes what is left in the queue before stopping
+        closing_.store(true, std::memory_order_release);
+        writer_.join();
+        queue_.reset();
+    }
+
+    flush();
+    file_.close();
+}
+
+bool SpikeRecorder::isOpen() const{
+
+    return file_.is_open();
+}
+
+unsigned long int SpikeRecorder::getNbSpikes() const{
+
+    return nbSpikes_;
+}
+
+SpikeWriterStatistics const& SpikeRecorder::getStatistics() const{
+
+    return statistics_;
+}
+
+void SpikeRecorder::printStatistics(std::ostream& out) const{
+
+    out << "Spikes recorded : " << getNbSpikes() << (getAsynchronous() ? " (asynchronous writer)" : " (synchronous writer)") << std::endl;
+    out << "Simulation thread waited " << statistics_.nbStalls << " times, " << statistics_.stallTime << " s in total" << std::endl;
+    if(getAsynchronous())
+        out << "Maximal occupancy of the queue : " << statistics_.maxOccupancy << " / " << bufferCapacity_ << " spikes" << std::endl;
+    out << statistics_.nbWrites << " writes in the file, " << statistics_.writeTime << " s in total" << std::endl;
+}
+
+/*********************************************************************/
+
+void SpikeRecorder::record(uint32_t const& step, uint32_t const& neuron){
+
+    SpikeRecord spike = {step, neuron};
+    ++nbSpikes_;
+
+    if(getAsynchronous()){
+        //Back-pressure : the queue is full, the simulation thread waits for the I/O thread
+        if(!queue_->push(spike)){
+            ++statistics_.nbStalls;
+            std::chrono::steady_clock::time_point begin(std::chrono::steady_clock::now());
+            while(!queue_->push(spike))
+                std::this_thread::yield();
+            statistics_.stallTime += secondsSince(begin);
+        }
+
+        //The occupancy is checked from time to time only, to avoid reading the index of the I/O thread at each spike
+        if((nbSpikes_ & 1023) == 0 and queue_->size() > statistics_.maxOccupancy)
+            statistics_.maxOccupancy = queue_->size();
+        return;
+    }
+
+    buffer_.push_back(spike);
+    if(buffer_.size() >= bufferCapacity_){
+        //The simulation thread waits during the write of the buffer
+        ++statistics_.nbStalls;
+        std::chrono::steady_clock::time_point begin(std::chrono::steady_clock::now());
+        flush();
+        statistics_.stallTime += secondsSince(begin);
+    }
+}
+
+void SpikeRecorder::flush(){
+
+    if(buffer_.empty())
+        return;
+
+    write(buffer_.data(), buffer_.size());
+    buffer_.clear();
+}
+
+unsigned long int SpikeRecorder::merge(std::vector<std::string> const& inputs, std::string const& output){
+
+    assert(!inputs.empty());
+    std::vector< std::unique_ptr<SpikeReader> > readers;
+    for(auto const& input : inputs){
+        readers.emplace_back(new SpikeReader(input));
+        SpikeFileHeader const& first(readers[0]->getHeader());
+        SpikeFileHeader const& header(readers.back()->getHeader());
+        if(header.h != first.h or header.nbNeurons != first.nbNeurons or header.g != first.g or header.eta != first.eta or header.seed != first.seed or header.connectivitySeed != first.connectivitySeed)
+            throw(input + std::string(" is not a file of the same simulation as ") + inputs[0]);
+    }
+
+    if(std::ofstream(output, std::ios::binary).fail())
+        throw(std::string("Impossible to open the spike file ") + output);
+    SpikeRecorder recorder;
+    recorder.open(output, readers[0]->getHeader());
+
+    //The next spike of each file, the files are sorted by timeStep
+    std::vector<SpikeRecord> spikes(readers.size());
+    std::vector<bool> left(readers.size());
+    for(size_t i(0) ; i < readers.size() ; ++i)
+        left[i] = readers[i]->next(spikes[i]);
+
+    while(true){
+        //The earliest spike, the first file if several spikes have the same timeStep
+        size_t earliest(readers.size());
+        for(size_t i(0) ; i < readers.size() ; ++i){
+            if(left[i] and (earliest == readers.size() or spikes[i].step < spikes[earliest].step))
+                earliest = i;
+        }
+        if(earliest == readers.size())
+            break;
+
+        //All the spikes of this timeStep in this file
+        const uint32_t step(spikes[earliest].step);
+        while(left[earliest] and spikes[earliest].step == step){
+            recorder.record(step, spikes[earliest].neuron);
+            left[earliest] = readers[earliest]->next(spikes[earliest]);
+        }
+    }
+
+    unsigned long int nbSpikes(recorder.getNbSpikes());
+    recorder.close();
+    return nbSpikes;
+}
+
+void SpikeRecorder::write(const SpikeRecord* spikes, size_t const& nb){
+
+    std::chrono::steady_clock::time_point begin(std::chrono::steady_clock::now());
+
+    //SpikeRecord is made of two uint32, without padding : the spikes are written at once
+    file_.write(reinterpret_cast<const char*>(spikes), nb*sizeof(SpikeRecord));
+    assert(!file_.fail());
+
+    ++statistics_.nbWrites;
+    statistics_.writeTime += secondsSince(begin);
+}
+
+void SpikeRecorder::writeLoop(){
+
+    //Second buffer : the I/O thread writes it while the simulation thread fills the queue
+    std::vector<SpikeRecord> chunk(1 << 16);
+
+    while(true){
+        size_t nb(queue_->pop(chunk.data(), chunk.size()));
+        if(nb > 0){
+            write(chunk.data(), nb);
+        }
+        //closing_ is set after the last push : once it is seen, an empty queue means that everything has been written
+        else if(closing_.load(std::memory_order_acquire)){
+            nb = queue_->pop(chunk.data(), chunk.size());
+            if(nb == 0)
+                break;
+            write(chunk.data(), nb);
+        }
+        else {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+}
+
+/*********************************************************************/
+
+SpikeReader::SpikeReader(std::string const& fileName)
+: file_(fileName, std::ios::binary)
+{
+    if(file_.fail())
+        throw(std::string("Impossible to open the spike file ") + fileName);
+
+    char fileMagic[sizeof(SpikeRecorder::magic)];
+    uint32_t fileVersion(0);
+    file_.read(fileMagic, sizeof(fileMagic));
+    readValue(file_, fileVersion);
+
+    if(file_.fail() or std::memcmp(fileMagic, SpikeRecorder::magic, sizeof(fileMagic)) != 0)
+        throw(fileName + std::string(" is not a binary spike file"));
+    if(fileVersion < 1 or fileVersion > SpikeRecorder::version)
+        throw(fileName + std::string(" has an unknown version of the spike format"));
+
+    readValue(file_, header_.h);
+    readValue(file_, header_.nbNeurons);
+    readValue(file_, header_.g);
+    readValue(file_, header_.eta);
+    readValue(file_, header_.seed);
+    header_.connectivitySeed = 0;
+    if(fileVersion >= 2)
+        readValue(file_, header_.connectivitySeed);
+
+    if(file_.fail())
+        throw(fileName + std::string(" has an incomplete header"));
+}
+
+SpikeFileHeader const& SpikeReader::getHeader() const{
+
+    return header_;
+}
+
+bool SpikeReader::next(SpikeRecord& spike){
+
+    readValue(file_, spike.step);
+    readValue(file_, spike.neuron);
+
+    return !file_.fail();
+}
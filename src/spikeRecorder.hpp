@@ -0,0 +1,228 @@
+#ifndef SPIKE_RECORDER_H
+#define SPIKE_RECORDER_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "spscQueue.hpp"
+
+
+//!  Struct SpikeRecord
+/*!
+ One spike of the binary spike file : the timeStep at which it happened and the id of the neuron that has spiked
+ */
+struct SpikeRecord{
+
+    uint32_t step; //!< TimeStep of the spike
+    uint32_t neuron; //!< Index of the neuron that has spiked
+};
+
+//!  Struct SpikeFileHeader
+/*!
+ Header at the beginning of a binary spike file, it contains the parameters of the simulation that has produced the spikes
+ */
+struct SpikeFileHeader{
+
+    double h; //!< Duration of a timeStep in [ms]
+    uint32_t nbNeurons; //!< Number of neurons of the network
+    double g; //!< Ratio Ji/Je
+    double eta; //!< Ratio Vext/Vthr
+    uint64_t seed; //!< Seed of the background noise
+    uint64_t connectivitySeed; //!< Seed of the connections (0 in the files of version 1, which didn't record it)
+};
+
+
+//!  Struct SpikeWriterStatistics
+/*!
+ Statistics on the writing of the spikes, to know if the disk kept up with the simulation.
+ A stall is a moment where the simulation thread had to wait for the output : a full queue in the asynchronous mode, a write of the buffer in the synchronous mode
+ */
+struct SpikeWriterStatistics{
+
+    unsigned long int nbStalls; //!< Number of times the simulation thread had to wait
+    double stallTime; //!< Total time the simulation thread has waited, in [s]
+    size_t maxOccupancy; //!< Maximal number of spikes waiting in the queue (asynchronous mode)
+    unsigned long int nbWrites; //!< Number of writes in the file
+    double writeTime; //!< Total time spent writing in the file, in [s]
+};
+
+
+//!  Class SpikeRecorder
+/*!
+ This class writes the spikes of a simulation in a compact binary file.
+
+ The file begins with the magic "BRUNSPK", the version of the format and the fields of SpikeFileHeader (the version 1 had no seed of the connections, it can still be read), then contains one SpikeRecord (two uint32, 8 bytes) per spike.
+ The spikes are kept in a large buffer in memory, which is written to the file only when it is full or when the recorder is closed : the stream is not flushed at each spike.
+ The tool SpikeExport converts a binary file into the text format "step id" read by plotA.py and plotB_C_D.py
+
+ In the asynchronous mode, the simulation thread doesn't write at all : it pushes the spikes in a lock-free single-producer/single-consumer queue, and a dedicated I/O thread drains the queue into its own buffer and writes it to the file (double buffering). The simulation thread only waits if the queue is full, which is counted in the statistics.
+ */
+
+class SpikeRecorder{
+
+    private:
+
+    std::ofstream file_; //!< The binary file
+    std::vector<SpikeRecord> buffer_; //!< Spikes that are not written in the file yet
+    size_t bufferCapacity_; //!< Number of spikes the buffer contains when it is written
+    unsigned long int nbSpikes_; //!< Number of spikes recorded since the opening of the file
+
+    bool asynchronous_; //!< True if the spikes are written by a dedicated I/O thread
+    std::unique_ptr< SpscQueue<SpikeRecord> > queue_; //!< Queue between the simulation thread and the I/O thread (asynchronous mode)
+    std::thread writer_; //!< The I/O thread (asynchronous mode)
+    std::atomic<bool> closing_; //!< Tells the I/O thread to write what is left in the queue and to stop
+    SpikeWriterStatistics statistics_; //!< Statistics of the output since the opening of the file
+
+
+    /*********************************************************************/
+
+    /**
+     * Writes spikes in the file, and measures the time needed
+     * @param spikes is a pointer on the first spike to write
+     * @param nb is the number of spikes to write
+     */
+    void write(const SpikeRecord* spikes, size_t const& nb);
+
+    /**
+     * Loop of the I/O thread : drains the queue and writes the spikes until the recorder is closed
+     */
+    void writeLoop();
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    static const char magic[8]; //!< First bytes of a binary spike file
+    static const uint32_t version; //!< Version of the format
+
+    /**
+     * Constructor of a recorder, no file is opened
+     * @param bufferCapacity is the number of spikes kept in memory before writing them (1M spikes, 8MB, by default)
+     */
+    SpikeRecorder(size_t const& bufferCapacity = 1 << 20);
+
+    /**
+     * Destructor, writes the spikes left in the buffer and closes the file
+     */
+    ~SpikeRecorder();
+
+    /*********************************************************************/
+
+    /**
+     * Chooses between the synchronous and the asynchronous mode. Has to be called when no file is opened
+     * @param b is true for the asynchronous mode (false by default)
+     */
+    void setAsynchronous(bool const& b);
+    /**
+     * @return asynchronous_
+     */
+    bool getAsynchronous() const;
+
+    /**
+     * Opens the binary file and writes its header. A file already opened is closed before. In the asynchronous mode, the I/O thread is started
+     * @param fileName is the name of the file
+     * @param header contains the parameters of the simulation
+     */
+    void open(std::string const& fileName, SpikeFileHeader const& header);
+
+    /**
+     * Writes the spikes left in the buffer (or in the queue) and closes the file. In the asynchronous mode, waits for the end of the I/O thread
+     */
+    void close();
+
+    /**
+     * @return true if a file is opened
+     */
+    bool isOpen() const;
+
+    /**
+     * @return the number of spikes recorded since the opening of the file
+     */
+    unsigned long int getNbSpikes() const;
+
+    /**
+     * Statistics of the output, complete once the file is closed
+     * @return statistics_
+     */
+    SpikeWriterStatistics const& getStatistics() const;
+
+    /**
+     * Prints the statistics of the output (number of spikes, waiting of the simulation thread, occupancy of the queue, writes)
+     * @param out is the stream where the statistics are printed
+     */
+    void printStatistics(std::ostream& out) const;
+
+    /*********************************************************************/
+
+    /**
+     * Adds a spike to the buffer, the buffer is written in the file if it is full. In the asynchronous mode, pushes the spike in the queue (waits if the queue is full)
+     * @param step is the timeStep of the spike
+     * @param neuron is the index of the neuron that has spiked
+     */
+    void record(uint32_t const& step, uint32_t const& neuron);
+
+    /**
+     * Writes all the spikes of the buffer in the file and empties it (nothing to do in the asynchronous mode)
+     */
+    void flush();
+
+    /**
+     * Merges the files of the spikes of the processes of a distributed simulation (see SpikeExchange) into one file, sorted by timeStep. The spikes of a timeStep are in the order of the files, which gives the file of a single process if the files are in the order of the ranks
+     * @param inputs are the names of the files of the processes
+     * @param output is the name of the merged file
+     * @return the number of spikes of the merged file
+     * @throw std::string if a file can't be read or written, or if the files are not the ones of the same simulation
+     */
+    static unsigned long int merge(std::vector<std::string> const& inputs, std::string const& output);
+
+};
+
+
+//!  Class SpikeReader
+/*!
+ This class reads a binary spike file written by SpikeRecorder : the header, then the spikes one by one
+ */
+
+class SpikeReader{
+
+    private:
+
+    std::ifstream file_; //!< The binary file
+    SpikeFileHeader header_; //!< The header of the file
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Opens a binary spike file and reads its header
+     * @param fileName is the name of the file
+     * @throw std::string if the file can't be opened or is not a spike file
+     */
+    SpikeReader(std::string const& fileName);
+
+    /**
+     * @return the header of the file
+     */
+    SpikeFileHeader const& getHeader() const;
+
+    /**
+     * Reads the next spike of the file
+     * @param spike receives the spike
+     * @return false if there is no spike left
+     */
+    bool next(SpikeRecord& spike);
+
+};
+
+#endif
@@ -0,0 +1,160 @@
+#include "spikeStatistics.hpp"
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <algorithm>
+
+SpikeStatistics::SpikeStatistics()
+: firstStep_(0), binSteps_(1), lastStep_(0), nbSpikes_(0)
+{}
+
+void SpikeStatistics::reset(size_t const& nbNeurons, unsigned long int const& firstStep, unsigned long int const& binSteps){
+
+    assert(binSteps > 0);
+    firstStep_ = firstStep;
+    binSteps_ = binSteps;
+    lastStep_ = firstStep;
+    nbSpikes_ = 0;
+
+    histogram_.clear();
+    spikeCounts_.assign(nbNeurons, 0);
+    lastSpike_.assign(nbNeurons, -1);
+    isiSum_.assign(nbNeurons, 0);
+    isiSquareSum_.assign(nbNeurons, 0);
+}
+
+void SpikeStatistics::record(unsigned long int const& step, size_t const& neuron){
+
+    assert(step >= firstStep_ and neuron < spikeCounts_.size());
+
+    //The histogram grows with the simulation
+    size_t bin((step - firstStep_)/binSteps_);
+    if(bin >= histogram_.size())
+        histogram_.resize(bin+1, 0);
+    ++histogram_[bin];
+
+    if(lastSpike_[neuron] >= 0){
+        double isi(step - lastSpike_[neuron]);
+        isiSum_[neuron] += isi;
+        isiSquareSum_[neuron] += isi*isi;
+    }
+    lastSpike_[neuron] = step;
+    ++spikeCounts_[neuron];
+
+    ++nbSpikes_;
+    markStep(step);
+}
+
+void SpikeStatistics::markStep(unsigned long int const& step){
+
+    assert(step >= firstStep_);
+
+    if(step >= lastStep_){
+        lastStep_ = step+1;
+        //The last bins exist even if they don't contain any spike
+        histogram_.resize((step - firstStep_)/binSteps_ + 1, 0);
+    }
+}
+
+void SpikeStatistics::reduce(SpikeExchange const& exchange){
+
+    //All the processes have marked the same timeSteps, and each neuron has spiked in a single process
+    assert(exchange.sum(histogram_.size()) == exchange.getNbProcesses()*histogram_.size());
+    exchange.sum(histogram_);
+    exchange.sum(spikeCounts_);
+    exchange.sum(isiSum_);
+    exchange.sum(isiSquareSum_);
+    nbSpikes_ = exchange.sum(nbSpikes_);
+}
+
+/*********************************************************************/
+
+unsigned long int SpikeStatistics::getNbSpikes() const{
+
+    return nbSpikes_;
+}
+
+unsigned long int SpikeStatistics::getBinSteps() const{
+
+    return binSteps_;
+}
+
+std::vector<uint32_t> const& SpikeStatistics::getHistogram() const{
+
+    return histogram_;
+}
+
+uint32_t SpikeStatistics::getSpikeCount(size_t const& neuron) const{
+
+    return spikeCounts_[neuron];
+}
+
+double SpikeStatistics::getCV(size_t const& neuron) const{
+
+    //n spikes give n-1 ISIs
+    if(spikeCounts_[neuron] < 3)
+        return -1;
+
+    double nbIsi(spikeCounts_[neuron] - 1);
+    double mean(isiSum_[neuron]/nbIsi);
+    double variance(isiSquareSum_[neuron]/nbIsi - mean*mean);
+    return std::sqrt(std::max(variance, 0.0))/mean;
+}
+
+double SpikeStatistics::getMeanRate(double const& h) const{
+
+    if(spikeCounts_.empty() or lastStep_ == firstStep_)
+        return 0;
+
+    //Number of spikes per neuron and per second
+    return nbSpikes_/(spikeCounts_.size()*(lastStep_ - firstStep_)*h*1e-3);
+}
+
+double SpikeStatistics::getMeanCV() const{
+
+    double sum(0);
+    size_t nb(0);
+    for(size_t neuron(0) ; neuron < spikeCounts_.size() ; ++neuron){
+        double cv(getCV(neuron));
+        if(cv >= 0){
+            sum += cv;
+            ++nb;
+        }
+    }
+
+    return nb > 0 ? sum/nb : -1;
+}
+
+/*********************************************************************/
+
+void SpikeStatistics::write(std::ostream& out, SpikeFileHeader const& header) const{
+
+    out << "# h " << header.h << std::endl;
+    out << "# neurons " << header.nbNeurons << std::endl;
+    out << "# g " << header.g << std::endl;
+    out << "# eta " << header.eta << std::endl;
+    out << "# seed " << header.seed << std::endl;
+    out << "# connectivity-seed " << header.connectivitySeed << std::endl;
+    out << "# spikes " << getNbSpikes() << std::endl;
+    out << "# rate " << getMeanRate(header.h) << std::endl;
+    out << "# cv " << getMeanCV() << std::endl;
+    out << "# bin_steps " << getBinSteps() << std::endl;
+    out << "# bins " << histogram_.size() << std::endl;
+
+    //Population histogram : beginning of the bin in [ms] and number of spikes
+    for(size_t bin(0) ; bin < histogram_.size() ; ++bin)
+        out << (firstStep_ + bin*binSteps_)*header.h << " " << histogram_[bin] << std::endl;
+
+    //Number of spikes and CV of each neuron
+    for(size_t neuron(0) ; neuron < spikeCounts_.size() ; ++neuron)
+        out << spikeCounts_[neuron] << " " << getCV(neuron) << std::endl;
+}
+
+void SpikeStatistics::write(std::string const& fileName, SpikeFileHeader const& header) const{
+
+    std::ofstream file(fileName);
+    if(file.fail())
+        throw(std::string("Impossible to open the statistics file ") + fileName);
+
+    write(file, header);
+}
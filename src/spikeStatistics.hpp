@@ -0,0 +1,128 @@
+#ifndef SPIKE_STATISTICS_H
+#define SPIKE_STATISTICS_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include "spikeRecorder.hpp"
+#include "spikeExchange.hpp"
+
+
+//!  Class SpikeStatistics
+/*!
+ This class computes statistics on the spikes during the simulation, so that the spike trains don't have to be written and read again to draw the firing frequency :
+ the number of spikes of the population in each bin of time (the histogram of plotA.py and plotB_C_D.py), the number of spikes of each neuron, the mean firing rate and the coefficient of variation (CV) of the interspike intervals (ISI).
+
+ The ISIs are not stored : each neuron keeps the time of its last spike, the sum and the sum of the squares of its ISIs, so that the memory doesn't depend on the duration of the simulation (except for the histogram).
+ The CV of a neuron is the standard deviation of its ISIs divided by their mean, it is computed for the neurons that have at least 2 ISIs.
+ */
+
+class SpikeStatistics{
+
+    private:
+
+    unsigned long int firstStep_; //!< TimeStep of the beginning of the first bin
+    unsigned long int binSteps_; //!< Number of timeSteps per bin
+    unsigned long int lastStep_; //!< TimeStep after the last one recorded
+    std::vector<uint32_t> histogram_; //!< Number of spikes of the population in each bin
+    std::vector<uint32_t> spikeCounts_; //!< Number of spikes of each neuron
+    std::vector<int64_t> lastSpike_; //!< TimeStep of the last spike of each neuron, -1 if it hasn't spiked
+    std::vector<double> isiSum_; //!< Sum of the ISIs of each neuron, in timeSteps
+    std::vector<double> isiSquareSum_; //!< Sum of the squares of the ISIs of each neuron
+    unsigned long int nbSpikes_; //!< Total number of spikes
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Constructor of empty statistics, use reset before recording
+     */
+    SpikeStatistics();
+
+    /**
+     * Forgets all the spikes and prepares the arrays
+     * @param nbNeurons is the number of neurons of the network
+     * @param firstStep is the first timeStep that will be recorded
+     * @param binSteps is the number of timeSteps per bin of the histogram
+     */
+    void reset(size_t const& nbNeurons, unsigned long int const& firstStep, unsigned long int const& binSteps);
+
+    /**
+     * Adds one spike. The spikes have to be recorded in increasing order of timeStep
+     * @param step is the timeStep of the spike, at least firstStep
+     * @param neuron is the index of the neuron that has spiked
+     */
+    void record(unsigned long int const& step, size_t const& neuron);
+    /**
+     * Marks a timeStep as simulated, even if no neuron has spiked : the mean rate is computed until the last timeStep marked, and the histogram contains its bin
+     * @param step is the timeStep
+     */
+    void markStep(unsigned long int const& step);
+    /**
+     * Adds the statistics of all the processes of a distributed simulation, at the end of the simulation : each process has recorded the spikes of its own neurons, the result is the statistics of the whole network. All the processes have to call it
+     * @param exchange connects the process to the other ones
+     */
+    void reduce(SpikeExchange const& exchange);
+
+    /*********************************************************************/
+
+    /**
+     * @return the total number of spikes
+     */
+    unsigned long int getNbSpikes() const;
+    /**
+     * @return binSteps_
+     */
+    unsigned long int getBinSteps() const;
+    /**
+     * @return the number of spikes of the population in each bin, the bin i begins at the timeStep firstStep + i*binSteps
+     */
+    std::vector<uint32_t> const& getHistogram() const;
+    /**
+     * @param neuron is the index of the neuron
+     * @return the number of spikes of the neuron
+     */
+    uint32_t getSpikeCount(size_t const& neuron) const;
+    /**
+     * @param neuron is the index of the neuron
+     * @return the CV of the ISIs of the neuron, -1 if it has less than 2 ISIs
+     */
+    double getCV(size_t const& neuron) const;
+
+    /**
+     * Mean firing rate of a neuron, from the first timeStep to the last one marked
+     * @param h is the duration of a timeStep in [ms]
+     * @return the rate in [Hz]
+     */
+    double getMeanRate(double const& h) const;
+    /**
+     * @return the mean of the CVs of the neurons that have at least 2 ISIs, -1 if there is none
+     */
+    double getMeanCV() const;
+
+    /*********************************************************************/
+
+    /**
+     * Writes the statistics in the text format of the summary file : lines "# key value" (the parameters of header, the number of spikes, the mean rate and CV, the size of the bins),
+     * then one line "time[ms] spikes" per bin, then one line "spikes cv" per neuron
+     * @param out is the stream where the statistics are written
+     * @param header contains the parameters of the simulation
+     */
+    void write(std::ostream& out, SpikeFileHeader const& header) const;
+    /**
+     * Writes the statistics in a summary file
+     * @param fileName is the name of the file
+     * @param header contains the parameters of the simulation
+     * @throw std::string if the file can't be opened
+     */
+    void write(std::string const& fileName, SpikeFileHeader const& header) const;
+
+};
+
+#endif
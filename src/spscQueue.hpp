@@ -0,0 +1,121 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <cassert>
+
+
+//!  Class SpscQueue
+/*!
+ Lock-free queue with a fixed capacity, for exactly one producer thread and one consumer thread (single-producer/single-consumer).
+ The elements are stored in a ring of capacity cases (a power of 2). The producer only writes tail_ and the consumer only writes head_, each one reading the index of the other with acquire/release atomics, so that no lock is ever taken.
+ The two indexes are separated by 64 bytes (on different cache lines), so that the two threads don't invalidate the cache of each other at each operation.
+ */
+
+template<typename T>
+class SpscQueue{
+
+    private:
+
+    std::vector<T> ring_; //!< The elements, the queue contains the cases head_ to tail_-1 (modulo the capacity)
+    size_t mask_; //!< capacity-1, to compute the modulo with a binary and
+
+    char padding1_[64]; //!< Separates head_ from the attributes above
+    std::atomic<size_t> head_; //!< Index of the next element to pop, written by the consumer only
+    size_t cachedTail_; //!< Last value of tail_ read by the consumer
+    char padding2_[64]; //!< Puts tail_ on another cache line than head_
+    std::atomic<size_t> tail_; //!< Index of the next element to push, written by the producer only
+    size_t cachedHead_; //!< Last value of head_ read by the producer
+    char padding3_[64]; //!< Separates tail_ from what follows the queue in memory
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Constructor of an empty queue
+     * @param capacity is the maximal number of elements, rounded up to a power of 2
+     */
+    SpscQueue(size_t const& capacity)
+    : head_(0), cachedTail_(0), tail_(0), cachedHead_(0)
+    {
+        size_t size(1);
+        while(size < capacity)
+            size *= 2;
+        ring_.resize(size);
+        mask_ = size-1;
+    }
+
+    /**
+     * @return the maximal number of elements of the queue
+     */
+    size_t capacity() const{
+
+        return ring_.size();
+    }
+
+    /**
+     * Number of elements of the queue. Exact only if the two threads don't modify the queue at the same time
+     * @return the number of elements
+     */
+    size_t size() const{
+
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Adds an element at the end of the queue. Called by the producer only
+     * @param value is the element to add
+     * @return false if the queue is full (nothing is added)
+     */
+    bool push(T const& value){
+
+        size_t tail(tail_.load(std::memory_order_relaxed));
+
+        //head_ is read again only if the queue seems full
+        if(tail - cachedHead_ == capacity()){
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if(tail - cachedHead_ == capacity())
+                return false;
+        }
+
+        ring_[tail & mask_] = value;
+        //The element is visible by the consumer once tail_ is published
+        tail_.store(tail+1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Removes up to maxNb elements from the beginning of the queue. Called by the consumer only
+     * @param out receives the elements removed
+     * @param maxNb is the maximal number of elements to remove
+     * @return the number of elements removed (0 if the queue is empty)
+     */
+    size_t pop(T* out, size_t const& maxNb){
+
+        size_t head(head_.load(std::memory_order_relaxed));
+
+        //tail_ is read again only if the queue seems empty
+        if(cachedTail_ == head)
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+
+        size_t nb(cachedTail_ - head);
+        if(nb > maxNb)
+            nb = maxNb;
+
+        for(size_t i(0) ; i < nb ; ++i)
+            out[i] = ring_[(head+i) & mask_];
+
+        //The cases are given back to the producer once head_ is published
+        head_.store(head+nb, std::memory_order_release);
+        return nb;
+    }
+
+};
+
+#endif
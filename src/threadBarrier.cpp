@@ -0,0 +1,28 @@
+#include "threadBarrier.hpp"
+#include <cassert>
+
+ThreadBarrier::ThreadBarrier(unsigned int const& nbThreads)
+: nbThreads_(nbThreads), nbWaiting_(0), generation_(0)
+{
+    assert(nbThreads_ > 0);
+}
+
+void ThreadBarrier::wait(){
+
+    //A single thread never has to wait
+    if(nbThreads_ == 1)
+        return;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    unsigned long int generation(generation_);
+
+    //The last thread to arrive wakes up all the others
+    if(++nbWaiting_ == nbThreads_){
+        nbWaiting_ = 0;
+        ++generation_;
+        condition_.notify_all();
+    }
+    else{
+        condition_.wait(lock, [this, generation]{ return generation != generation_; });
+    }
+}
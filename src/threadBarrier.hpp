@@ -0,0 +1,43 @@
+#ifndef THREAD_BARRIER_H
+#define THREAD_BARRIER_H
+
+#include <mutex>
+#include <condition_variable>
+
+
+//!  Class ThreadBarrier
+/*!
+ This class synchronises a fixed number of threads : each thread calling wait is blocked until all the threads have called wait. The barrier can then be used again for the next synchronisation (it is used once per window of timeSteps by the threads of Network::updateNetwork).
+ */
+
+class ThreadBarrier{
+
+    private:
+
+    unsigned int nbThreads_; //!< Number of threads that have to reach the barrier
+    unsigned int nbWaiting_; //!< Number of threads that are waiting in the current use of the barrier
+    unsigned long int generation_; //!< Number of times the barrier has been passed, enables to reuse it
+    std::mutex mutex_; //!< Protects nbWaiting_ and generation_
+    std::condition_variable condition_; //!< The waiting threads sleep on it
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    /**
+     * Constructor of a barrier
+     * @param nbThreads is the number of threads that will use the barrier
+     */
+    ThreadBarrier(unsigned int const& nbThreads);
+
+    /**
+     * Blocks the calling thread until nbThreads_ threads have called wait
+     */
+    void wait();
+
+};
+
+#endif
@@ -0,0 +1,58 @@
+#include "xoshiro256.hpp"
+#include <cassert>
+
+Xoshiro256::Xoshiro256(uint64_t const& seed, uint64_t const& stream){
+
+    this->seed(seed, stream);
+}
+
+void Xoshiro256::seed(uint64_t const& seed, uint64_t const& stream){
+
+    //splitmix64 : four well mixed words, never all 0
+    uint64_t x(seed);
+    for(unsigned int i(0) ; i < 4 ; ++i){
+        uint64_t z(x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27))*0x94d049bb133111ebULL;
+        state_[i] = z ^ (z >> 31);
+    }
+
+    for(uint64_t s(0) ; s < stream ; ++s)
+        jump();
+}
+
+void Xoshiro256::jump(){
+
+    //Polynomial of the jump of 2^128 given by the authors of xoshiro256**
+    static const uint64_t JUMP[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+    uint64_t s0(0), s1(0), s2(0), s3(0);
+    for(unsigned int i(0) ; i < 4 ; ++i){
+        for(unsigned int b(0) ; b < 64 ; ++b){
+            if(JUMP[i] & (uint64_t(1) << b)){
+                s0 ^= state_[0];
+                s1 ^= state_[1];
+                s2 ^= state_[2];
+                s3 ^= state_[3];
+            }
+            (*this)();
+        }
+    }
+
+    state_[0] = s0;
+    state_[1] = s1;
+    state_[2] = s2;
+    state_[3] = s3;
+}
+
+uint64_t Xoshiro256::getState(unsigned int const& i) const{
+
+    assert(i < 4);
+    return state_[i];
+}
+
+void Xoshiro256::setState(unsigned int const& i, uint64_t const& word){
+
+    assert(i < 4);
+    state_[i] = word;
+}
@@ -0,0 +1,101 @@
+#ifndef XOSHIRO256_H
+#define XOSHIRO256_H
+
+#include <cstdint>
+
+
+//!  Class Xoshiro256
+/*!
+ Random generator xoshiro256** (Blackman and Vigna) : 256 bits of state, period 2^256-1, a few additions, shifts and rotations per number, much faster than std::mt19937.
+ The state is initialised from a 64 bits seed with splitmix64. jump() advances the generator of 2^128 numbers : the generator of the stream s is the seeded generator jumped s times, so that the streams never overlap.
+ It satisfies the requirements of a UniformRandomBitGenerator, so it can also be used with the distributions of <random>.
+ */
+
+class Xoshiro256{
+
+    private:
+
+    uint64_t state_[4]; //!< The state of the generator
+
+
+    /*********************************************************************/
+    //PUBLIC PART
+    /*********************************************************************/
+
+    public:
+
+    typedef uint64_t result_type; //!< Type of the numbers generated
+
+    /**
+     * Constructor of a generator
+     * @param seed is the seed, given to splitmix64 to fill the state
+     * @param stream is the number of jumps of 2^128 numbers after the seeding
+     */
+    Xoshiro256(uint64_t const& seed = 0, uint64_t const& stream = 0);
+
+    /**
+     * Initialises the state from a seed, then jumps to the stream
+     * @param seed is the seed, given to splitmix64 to fill the state
+     * @param stream is the number of jumps of 2^128 numbers after the seeding
+     */
+    void seed(uint64_t const& seed, uint64_t const& stream = 0);
+
+    /**
+     * Advances the generator of 2^128 numbers
+     */
+    void jump();
+
+    /**
+     * @param i is the index of the word (0 to 3)
+     * @return the word i of the state, to save the generator
+     */
+    uint64_t getState(unsigned int const& i) const;
+    /**
+     * Setter of one word of the state, to restore a saved generator
+     * @param i is the index of the word (0 to 3)
+     * @param word is the new value of the word
+     */
+    void setState(unsigned int const& i, uint64_t const& word);
+
+    /**
+     * @return the smallest number that can be generated
+     */
+    static constexpr uint64_t min() { return 0; }
+    /**
+     * @return the biggest number that can be generated
+     */
+    static constexpr uint64_t max() { return UINT64_MAX; }
+
+    /**
+     * Generates the next number. Defined in the header, so that it is inlined in the loops that draw many numbers
+     * @return 64 random bits
+     */
+    uint64_t operator()(){
+
+        const uint64_t result(rotl(state_[1]*5, 7)*9);
+        const uint64_t t(state_[1] << 17);
+
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+
+        return result;
+    }
+
+    /**
+     * Left rotation of the bits of a word
+     * @param x is the word
+     * @param k is the number of bits of the rotation (1 to 63)
+     * @return the rotated word
+     */
+    static uint64_t rotl(uint64_t const& x, int const& k){
+
+        return (x << k) | (x >> (64 - k));
+    }
+
+};
+
+#endif
@@ -0,0 +1,205 @@
+#include "neuron.hpp"
+#include "network.hpp"
+#include "connectivityGenerator.hpp"
+#include "benchmark/benchmark.h"
+
+/**
+ * Microbenchmarks of the hot paths of the simulation, and macro benchmark of the network of 12500 neurons in the four regimes of the figure 8 of Brunel's paper.
+ * The throughputs are reported as counters per second : neuron-updates/s (one neuron integrated during one timeStep) and synaptic-events/s (one spike delivered to one target).
+ */
+
+namespace {
+
+    const unsigned long int nbNeurons(12500); //!< Size of the network of the paper
+    const unsigned long int connectivitySeed(2024); //!< The same connections in all the benchmarks
+    const unsigned long int noiseSeed(7); //!< The same background noise in all the benchmarks
+
+    /**
+     * @return the connections of the network of 12500 neurons, generated once for all the benchmarks
+     */
+    Connectivity const& getConnections(){
+
+        static const Connectivity connections(ConnectivityGenerator(0.8*nbNeurons, 0.2*nbNeurons, epsilon, connectivitySeed).generate());
+        return connections;
+    }
+}
+
+/**
+ * Update of one Neuron (object version) during one timeStep, with a spike in its buffer every timeStep
+ */
+static void BM_NeuronUpdate(benchmark::State& state){
+
+    Neuron neuron;
+    neuron.setI(1.01);
+    size_t Jidx(0);
+    int time(0);
+
+    for(auto _ : state){
+        neuron.jToAdd_[Jidx] += 0.1;
+        benchmark::DoNotOptimize(neuron.update(Jidx, time));
+        Jidx = (Jidx + 1) % neuron.jToAdd_.size();
+        ++time;
+    }
+
+    state.counters["neuron-updates/s"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_NeuronUpdate);
+
+/**
+ * Update of all the neurons of a population during one timeStep, in a precision, with the membrane kernel of the given instruction set
+ */
+template<typename Precision>
+static void BM_PopulationUpdate(benchmark::State& state){
+
+    MembraneKernel::Instructions instructions(static_cast<MembraneKernel::Instructions>(state.range(0)));
+    if(!MembraneKernel::isAvailable(instructions)){
+        state.SkipWithError("instruction set not available");
+        return;
+    }
+
+    BasicNeuronPopulation<Precision> neurons;
+    neurons.resize(nbNeurons, 0.8*nbNeurons);
+    neurons.setKernel(instructions);
+    std::vector<uint32_t> spiking;
+    int time(0);
+    state.SetLabel(neurons.getKernel().getName());
+
+    for(auto _ : state){
+        //Some input in the slot read, so that the neurons integrate and spike from time to time
+        size_t Jidx(time % neurons.getNbSlots());
+        typename Precision::Input* slot(neurons.getSlot(Jidx));
+        for(size_t idx(time % 7) ; idx < nbNeurons ; idx += 7)
+            slot[idx] = 3;
+        spiking.clear();
+        neurons.updateAll(Jidx, time, spiking);
+        benchmark::DoNotOptimize(spiking.data());
+        ++time;
+    }
+
+    state.counters["neuron-updates/s"] = benchmark::Counter(state.iterations()*nbNeurons, benchmark::Counter::kIsRate);
+}
+BENCHMARK_TEMPLATE(BM_PopulationUpdate, DoublePrecision)->Arg(MembraneKernel::Scalar)->Arg(MembraneKernel::AVX2)->Arg(MembraneKernel::AVX512);
+BENCHMARK_TEMPLATE(BM_PopulationUpdate, SinglePrecision)->Arg(MembraneKernel::Scalar)->Arg(MembraneKernel::AVX2)->Arg(MembraneKernel::AVX512);
+BENCHMARK_TEMPLATE(BM_PopulationUpdate, MixedPrecision)->Arg(MembraneKernel::AVX512);
+
+/**
+ * Draws of the background noise of all the neurons for one timeStep (Poisson distribution of mean Vext*h = 2, eta = 2)
+ */
+static void BM_PoissonDraw(benchmark::State& state){
+
+    BackgroundNoise noise(2, noiseSeed);
+    std::vector<unsigned int> counts(nbNeurons);
+
+    for(auto _ : state){
+        noise.fill(counts.data(), counts.size());
+        benchmark::DoNotOptimize(counts.data());
+    }
+
+    state.counters["draws/s"] = benchmark::Counter(state.iterations()*nbNeurons, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_PoissonDraw);
+
+/**
+ * Delivery of the spikes of all the neurons, one after the other, to all their targets, in the buffers (0) or in the spike counters (1), with the stored (0), the procedural (1) or the compact (2) connections
+ */
+static void BM_SpikeFanOut(benchmark::State& state){
+
+    Network net(false, 5, 2, nbNeurons, connectivitySeed, noiseSeed);
+    net.setSpikeCounters(state.range(0));
+    net.setProceduralConnectivity(state.range(1) == 1);
+    net.setCompactConnectivity(state.range(1) == 2);
+    net.createNetwork(state.range(1) == 1 ? Connectivity() : getConnections());
+    size_t source(0);
+    unsigned long int nbEvents(0);
+
+    for(auto _ : state){
+        net.sendSpike(source);
+        nbEvents += state.range(1) == 1 ? net.getProceduralConnections().getNbTargets() : getConnections()[source].size();
+        source = (source + 1) % nbNeurons;
+    }
+
+    state.counters["synaptic-events/s"] = benchmark::Counter(nbEvents, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_SpikeFanOut)->Args({0, 0})->Args({1, 0})->Args({0, 1})->Args({1, 1})->Args({0, 2})->Args({1, 2});
+
+/**
+ * Creation of the network of 12500 neurons : generation of the connections and of the neurons
+ */
+static void BM_CreateNetwork(benchmark::State& state){
+
+    for(auto _ : state){
+        Network net(true, 5, 2, nbNeurons, connectivitySeed, noiseSeed);
+        net.createNetwork();
+        benchmark::DoNotOptimize(net.neuronConnections_.getNbSynapses());
+    }
+
+    state.counters["synapses/s"] = benchmark::Counter(state.iterations()*getConnections().getNbSynapses(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_CreateNetwork)->Unit(benchmark::kMillisecond);
+
+/**
+ * Simulation of 100 ms (1000 timeSteps) of the network of 12500 neurons in a precision, without writing the spikes, in one of the four regimes of the figure 8 : A (g=3, eta=2), B (g=6, eta=4), C (g=5, eta=2), D (g=4.5, eta=0.9), with the buffers (0) or the spike counters (1), a mode of delivery of the spikes (push, pull or auto), and the stored (0), the procedural (1) or the compact (2) connections
+ * The synaptic events are the spikes times the mean number of targets of a neuron
+ */
+template<typename Precision>
+static void BM_Network(benchmark::State& state){
+
+    static const double regimes[4][2] = {{3, 2}, {6, 4}, {5, 2}, {4.5, 0.9}};
+    static const char* names[4] = {"A", "B", "C", "D"};
+    const double g(regimes[state.range(0)][0]);
+    const double eta(regimes[state.range(0)][1]);
+    const unsigned long int nbSteps(1000);
+    const SpikeGather::Mode delivery(static_cast<SpikeGather::Mode>(state.range(2)));
+    state.SetLabel(std::string(names[state.range(0)]) + (state.range(1) ? ", counters" : "") + ", " + SpikeGather::getName(delivery) + (state.range(3) == 1 ? ", procedural" : "") + (state.range(3) == 2 ? ", compact" : ""));
+
+    Connectivity const& connections(getConnections());
+    double meanTargets(double(connections.getNbSynapses())/nbNeurons);
+    unsigned long int nbSpikes(0);
+
+    for(auto _ : state){
+        //The creation of the neurons is not measured
+        state.PauseTiming();
+        BasicNetwork<Precision> net(true, g, eta, nbNeurons, connectivitySeed, noiseSeed);
+        net.setSpikeCounters(state.range(1));
+        net.setDelivery(delivery);
+        net.setProceduralConnectivity(state.range(3) == 1);
+        net.setCompactConnectivity(state.range(3) == 2);
+        net.setSpikesFileName("");
+        net.createNetwork(state.range(3) == 1 ? Connectivity() : connections);
+        state.ResumeTiming();
+
+        net.updateNetwork(0, nbSteps);
+        nbSpikes += net.getNbRecordedSpikes();
+    }
+
+    state.counters["neuron-updates/s"] = benchmark::Counter(state.iterations()*nbSteps*nbNeurons, benchmark::Counter::kIsRate);
+    state.counters["synaptic-events/s"] = benchmark::Counter(nbSpikes*meanTargets, benchmark::Counter::kIsRate);
+    state.counters["rate[Hz]"] = nbSpikes/(state.iterations()*nbNeurons*nbSteps*h*1e-3);
+}
+
+/**
+ * The four regimes with the buffers and the push delivery, with the spike counters if counters is true, with the pull and the automatic delivery if delivery is true, and with the procedural and the compact connections if connectivity is true
+ */
+static void addRegimes(benchmark::internal::Benchmark* benchmark, bool const& counters, bool const& delivery, bool const& connectivity){
+
+    for(int regime(0) ; regime < 4 ; ++regime){
+        benchmark->Args({regime, 0, SpikeGather::Push, 0});
+        if(counters)
+            benchmark->Args({regime, 1, SpikeGather::Push, 0});
+        //The pull delivery reads all the connections at each timeStep, it is only measured in the cheapest regime
+        if(delivery and regime == 3)
+            benchmark->Args({regime, 0, SpikeGather::Pull, 0});
+        if(delivery)
+            benchmark->Args({regime, 0, SpikeGather::Automatic, 0});
+        if(connectivity){
+            benchmark->Args({regime, 0, SpikeGather::Push, 1});
+            benchmark->Args({regime, 0, SpikeGather::Push, 2});
+        }
+    }
+    benchmark->Unit(benchmark::kMillisecond);
+}
+BENCHMARK_TEMPLATE(BM_Network, DoublePrecision)->Apply([](benchmark::internal::Benchmark* b){ addRegimes(b, true, true, true); });
+BENCHMARK_TEMPLATE(BM_Network, SinglePrecision)->Apply([](benchmark::internal::Benchmark* b){ addRegimes(b, true, false, false); });
+BENCHMARK_TEMPLATE(BM_Network, MixedPrecision)->Apply([](benchmark::internal::Benchmark* b){ addRegimes(b, false, false, false); });
+
+BENCHMARK_MAIN();
@@ -1,5 +1,8 @@
 #include "neuron.hpp"
 #include "network.hpp"
+#include "simulationConfig.hpp"
+#include "parameterSweep.hpp"
+#include "precisionValidation.hpp"
 #include "gtest/gtest.h"
 
 /**
@@ -188,6 +191,745 @@ TEST (NeuronTest, TimeSpike){
     
 }
 
+/**
+ * Test that a neuron of a NeuronPopulation has exactly the same behavior as a Neuron (same membrane potential at each step, same spikes)
+ */
+TEST (NeuronPopulation, SameAsNeuron){
+
+    //One neuron alone and a population of 3 neurons, the second one with the same input as the neuron
+    Neuron neuron(false);
+    neuron.setI(1.01);
+    NeuronPopulation population;
+    population.resize(3,1);
+    population.setI(1,1.01);
+
+    EXPECT_EQ(3, population.size());
+    EXPECT_TRUE(population.getIsExcitatory(0));
+    EXPECT_FALSE(population.getIsExcitatory(1));
+
+    std::vector<uint32_t> spiking;
+    int nbSpikes(0);
+    for(int clock(0) ; clock < 4000 ; ++clock){
+        bool spike(neuron.update(0,clock));
+        population.updateAll(0, clock, spiking);
+
+        EXPECT_EQ(neuron.getMembranePotential(), population.getMembranePotential(1));
+        EXPECT_EQ(spike, spiking.size()==1);
+        if(spike){
+            EXPECT_EQ(1u, spiking[0]);
+            ++nbSpikes;
+        }
+    }
+    //Same spikes as in the test TimeSpike
+    EXPECT_EQ(4, nbSpikes);
+    //The neurons without input stay at rest
+    EXPECT_EQ(0, population.getMembranePotential(0));
+    EXPECT_EQ(0, population.getMembranePotential(2));
+}
+
+/**
+ * Test that the vector versions of MembraneKernel available on this processor give bit-identical results to the scalar version : refractory neurons, neurons above the threshold and integrating neurons mixed in a block whose size is not a multiple of the vector width
+ */
+TEST (MembraneKernel, sameAsScalar){
+
+    const size_t nb(1003);
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> potential(-5, 25), input(-10, 10), current(0, 1.5);
+    std::uniform_int_distribution<int> lastSpike(900, 1000);
+
+    std::vector<double> V(nb), ts(nb), I(nb), in(nb);
+    for(size_t i(0) ; i < nb ; ++i){
+        V[i] = potential(gen);
+        ts[i] = lastSpike(gen);
+        I[i] = current(gen);
+        in[i] = input(gen);
+    }
+
+    PhysicsParameters physics;
+    MembraneKernel scalar(MembraneKernel::Scalar);
+    EXPECT_EQ("scalar", scalar.getName());
+    std::vector<MembraneKernel::Instructions> vectors = {MembraneKernel::AVX2, MembraneKernel::AVX512};
+
+    for(auto instructions : vectors){
+        if(!MembraneKernel::isAvailable(instructions))
+            continue;
+        MembraneKernel kernel(instructions);
+
+        std::vector<double> V1(V), ts1(ts), V2(V), ts2(ts);
+        std::vector<uint32_t> spiking1, spiking2;
+        //Several steps, so that the neurons that spike become refractory
+        for(int time(1000) ; time < 1030 ; ++time){
+            scalar.integrate(V1.data(), ts1.data(), I.data(), in.data(), nb, time, 10, physics, spiking1);
+            kernel.integrate(V2.data(), ts2.data(), I.data(), in.data(), nb, time, 10, physics, spiking2);
+        }
+
+        EXPECT_FALSE(spiking1.empty());
+        EXPECT_EQ(spiking1, spiking2);
+        for(size_t i(0) ; i < nb ; ++i){
+            ASSERT_EQ(V1[i], V2[i]);
+            ASSERT_EQ(ts1[i], ts2[i]);
+        }
+    }
+}
+
+/**
+ * Test that the vector versions of MembraneKernel in float (SinglePrecision) and with buffers in float (MixedPrecision) give bit-identical results to the scalar versions, like in double
+ */
+TEST (MembraneKernel, sameAsScalarInFloat){
+
+    const size_t nb(1003);
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<float> potential(-5, 25), input(-10, 10), current(0, 1.5);
+    std::uniform_int_distribution<int> lastSpike(900, 1000);
+
+    std::vector<float> V(nb), ts(nb), I(nb), in(nb);
+    for(size_t i(0) ; i < nb ; ++i){
+        V[i] = potential(gen);
+        ts[i] = lastSpike(gen);
+        I[i] = current(gen);
+        in[i] = input(gen);
+    }
+    std::vector<double> Vd(V.begin(), V.end()), tsd(ts.begin(), ts.end()), Id(I.begin(), I.end());
+
+    PhysicsParameters physics;
+    MembraneKernel scalar(MembraneKernel::Scalar);
+    std::vector<MembraneKernel::Instructions> vectors = {MembraneKernel::AVX2, MembraneKernel::AVX512};
+
+    for(auto instructions : vectors){
+        if(!MembraneKernel::isAvailable(instructions))
+            continue;
+        MembraneKernel kernel(instructions);
+
+        std::vector<float> V1(V), ts1(ts), V2(V), ts2(ts);
+        std::vector<double> Vd1(Vd), tsd1(tsd), Vd2(Vd), tsd2(tsd);
+        std::vector<uint32_t> spiking1, spiking2, spikingd1, spikingd2;
+        for(int time(1000) ; time < 1030 ; ++time){
+            scalar.integrate(V1.data(), ts1.data(), I.data(), in.data(), nb, time, 10, physics, spiking1);
+            kernel.integrate(V2.data(), ts2.data(), I.data(), in.data(), nb, time, 10, physics, spiking2);
+            scalar.integrate(Vd1.data(), tsd1.data(), Id.data(), in.data(), nb, time, 10, physics, spikingd1);
+            kernel.integrate(Vd2.data(), tsd2.data(), Id.data(), in.data(), nb, time, 10, physics, spikingd2);
+        }
+
+        EXPECT_FALSE(spiking1.empty());
+        EXPECT_EQ(spiking1, spiking2);
+        EXPECT_EQ(spikingd1, spikingd2);
+        for(size_t i(0) ; i < nb ; ++i){
+            ASSERT_EQ(V1[i], V2[i]);
+            ASSERT_EQ(ts1[i], ts2[i]);
+            ASSERT_EQ(Vd1[i], Vd2[i]);
+            ASSERT_EQ(tsd1[i], tsd2[i]);
+        }
+    }
+}
+
+/**
+ * Test that the vector versions of MembraneKernel that read spike counters give bit-identical results to the scalar version, in double and in float, and the same results as a buffer that contains excitatory - g*inhibitory
+ */
+TEST (MembraneKernel, sameAsScalarWithCounters){
+
+    const size_t nb(1003);
+    const double g(5);
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> potential(-5, 25), current(0, 1.5);
+    std::uniform_int_distribution<int> lastSpike(900, 1000), count(0, 60);
+
+    std::vector<double> V(nb), ts(nb), I(nb), in(nb);
+    std::vector<uint16_t> excitatory(nb), inhibitory(nb);
+    for(size_t i(0) ; i < nb ; ++i){
+        V[i] = potential(gen);
+        ts[i] = lastSpike(gen);
+        I[i] = current(gen);
+        excitatory[i] = count(gen);
+        inhibitory[i] = count(gen)/4;
+        in[i] = excitatory[i] - g*inhibitory[i];
+    }
+    std::vector<float> Vf(V.begin(), V.end()), tsf(ts.begin(), ts.end()), If(I.begin(), I.end());
+
+    PhysicsParameters physics;
+    MembraneKernel scalar(MembraneKernel::Scalar);
+    std::vector<MembraneKernel::Instructions> all = {MembraneKernel::Scalar, MembraneKernel::AVX2, MembraneKernel::AVX512};
+
+    //The reference : the scalar kernel with a buffer
+    std::vector<double> V0(V), ts0(ts);
+    std::vector<float> Vf0(Vf), tsf0(tsf);
+    std::vector<uint32_t> spiking0, spikingf0;
+    for(int time(1000) ; time < 1030 ; ++time){
+        scalar.integrate(V0.data(), ts0.data(), I.data(), in.data(), nb, time, 0, physics, spiking0);
+        scalar.integrate(Vf0.data(), tsf0.data(), If.data(), std::vector<float>(in.begin(), in.end()).data(), nb, time, 0, physics, spikingf0);
+    }
+    EXPECT_FALSE(spiking0.empty());
+
+    for(auto instructions : all){
+        if(!MembraneKernel::isAvailable(instructions))
+            continue;
+        MembraneKernel kernel(instructions);
+
+        std::vector<double> V1(V), ts1(ts);
+        std::vector<float> Vf1(Vf), tsf1(tsf);
+        std::vector<uint32_t> spiking1, spikingf1;
+        for(int time(1000) ; time < 1030 ; ++time){
+            kernel.integrate(V1.data(), ts1.data(), I.data(), excitatory.data(), inhibitory.data(), g, nb, time, 0, physics, spiking1);
+            kernel.integrate(Vf1.data(), tsf1.data(), If.data(), excitatory.data(), inhibitory.data(), g, nb, time, 0, physics, spikingf1);
+        }
+
+        EXPECT_EQ(spiking0, spiking1);
+        EXPECT_EQ(spikingf0, spikingf1);
+        for(size_t i(0) ; i < nb ; ++i){
+            ASSERT_EQ(V0[i], V1[i]);
+            ASSERT_EQ(ts0[i], ts1[i]);
+            ASSERT_EQ(Vf0[i], Vf1[i]);
+            ASSERT_EQ(tsf0[i], tsf1[i]);
+        }
+    }
+}
+
+/**
+ * Test the layout [slot][neuron] of DelayRingBuffer : a slot is contiguous, and emptying a range of it doesn't touch the other neurons and the other slots
+ */
+TEST (DelayRingBuffer, slots){
+
+    DelayRingBuffer buffer;
+    buffer.resize(10, DelayInSteps);
+    EXPECT_EQ(jToAddLength, buffer.getNbSlots());
+    EXPECT_EQ(10, buffer.getNbNeurons());
+
+    for(size_t slot(0) ; slot < buffer.getNbSlots() ; ++slot){
+        for(size_t idx(0) ; idx < 10 ; ++idx)
+            buffer.getSlot(slot)[idx] = slot*10 + idx;
+    }
+    //The slots are one after the other
+    EXPECT_EQ(buffer.getSlot(0) + 10, buffer.getSlot(1));
+
+    buffer.clear(3, 2, 7);
+    for(size_t idx(0) ; idx < 10 ; ++idx){
+        EXPECT_EQ((idx >= 2 and idx < 7) ? 0 : 30 + idx, buffer.getSlot(3)[idx]);
+        EXPECT_EQ(40 + idx, buffer.getSlot(4)[idx]);
+    }
+}
+
+/**
+ * Test that a default PhysicsParameters gives the constants of Utility/Constants.h
+ */
+TEST (PhysicsParameters, defaultIsConstants){
+
+    PhysicsParameters physics;
+    EXPECT_EQ(h, physics.getH());
+    EXPECT_EQ(DelayInSteps, physics.getDelayInSteps());
+    EXPECT_EQ(refractoryTimeStep, physics.getRefractoryTimeStep());
+    EXPECT_EQ(scalarCste1, physics.getScalarCste1());
+    EXPECT_EQ(scalarCste2, physics.getScalarCste2());
+
+    //A longer delay gives more slots to the buffers
+    Network net(false, 5, 2, 100, PhysicsParameters(0.1, 3, 0.1, 20, 0.1));
+    net.createNetwork();
+    EXPECT_EQ(31, net.neurons.getNbSlots());
+    EXPECT_EQ(30, net.getJidxToWrite());
+}
+
+/**
+ * Test the reading of the parameters : keyed file, old positional format, overriding by the command line and validation
+ */
+TEST (SimulationConfig, fileAndCommandLine){
+
+    SimulationConfig config;
+    std::istringstream file("# comment\ng = 4.5\nneurons = 1000 # end of line\nh=0.05\n");
+    config.load(file, "test");
+    EXPECT_EQ(4.5, config.getG());
+    EXPECT_EQ(1000, config.getNbNeurons());
+    EXPECT_EQ(0.05, config.getPhysics().getH());
+    //Default values
+    EXPECT_EQ(2, config.getEta());
+    EXPECT_FALSE(config.hasSeed());
+
+    const char* argv[] = {"Neuron", "--g", "6", "--seed=42", "--threads", "2", "--output", "out.bin"};
+    config.parseArguments(8, argv);
+    EXPECT_EQ(6, config.getG());
+    EXPECT_TRUE(config.hasSeed());
+    EXPECT_EQ(42, config.getSeed());
+    EXPECT_EQ(2, config.getNbThreads());
+    EXPECT_EQ("out.bin", config.getOutput());
+    EXPECT_NO_THROW(config.validate());
+    //Where the parameters were given, to compare them with a checkpoint
+    EXPECT_EQ("command line", config.getOrigin("g"));
+    EXPECT_EQ("test line 3", config.getOrigin("neurons"));
+    EXPECT_EQ("", config.getOrigin("eta"));
+
+    //Old format of param.in
+    SimulationConfig positional;
+    std::istringstream oldFile("3\n1\n200\n10\n20\n");
+    positional.load(oldFile, "test");
+    EXPECT_EQ(3, positional.getG());
+    EXPECT_EQ(200, positional.getNbNeurons());
+    EXPECT_EQ(20, positional.getStop());
+
+    //Invalid parameters
+    const char* unknown[] = {"Neuron", "--gg", "6"};
+    EXPECT_THROW(config.parseArguments(3, unknown), std::string);
+    const char* notNumber[] = {"Neuron", "--eta", "two"};
+    EXPECT_THROW(config.parseArguments(3, notNumber), std::string);
+    const char* badStop[] = {"Neuron", "--stop", "500", "--start", "600"};
+    config.parseArguments(5, badStop);
+    EXPECT_THROW(config.validate(), std::string);
+    const char* badThreshold[] = {"Neuron", "--start", "0", "--pull-threshold", "1.5"};
+    config.parseArguments(5, badThreshold);
+    EXPECT_THROW(config.validate(), std::string);
+    const char* threshold[] = {"Neuron", "--pull-threshold", "0.05"};
+    config.parseArguments(3, threshold);
+    EXPECT_NO_THROW(config.validate());
+    EXPECT_EQ(0.05, config.getPullThreshold());
+}
+
+/**
+ * Test the statistics of SpikeStatistics on spikes computed by hand : histogram, counts, rate and CV
+ */
+TEST (SpikeStatistics, histogramRateCV){
+
+    SpikeStatistics statistics;
+    statistics.reset(3, 10, 5);
+
+    //Neuron 0 : ISIs 4 and 4 (CV 0), neuron 1 : ISIs 2 and 6 (mean 4, standard deviation 2, CV 0.5), neuron 2 : silent
+    statistics.record(10, 0);
+    statistics.record(10, 1);
+    statistics.record(12, 1);
+    statistics.record(14, 0);
+    statistics.record(18, 0);
+    statistics.record(18, 1);
+    statistics.markStep(24);
+
+    ASSERT_EQ(3, statistics.getHistogram().size());
+    EXPECT_EQ(4, statistics.getHistogram()[0]);
+    EXPECT_EQ(2, statistics.getHistogram()[1]);
+    EXPECT_EQ(0, statistics.getHistogram()[2]);
+
+    EXPECT_EQ(6, statistics.getNbSpikes());
+    EXPECT_EQ(3, statistics.getSpikeCount(0));
+    EXPECT_EQ(0, statistics.getSpikeCount(2));
+    EXPECT_NEAR(0, statistics.getCV(0), 1e-12);
+    EXPECT_NEAR(0.5, statistics.getCV(1), 1e-12);
+    EXPECT_EQ(-1, statistics.getCV(2));
+    EXPECT_NEAR(0.25, statistics.getMeanCV(), 1e-12);
+    //6 spikes, 3 neurons, 15 timeSteps of 0.1 ms
+    EXPECT_NEAR(6/(3*15*0.1e-3), statistics.getMeanRate(0.1), 1e-9);
+
+    //A single process already has the statistics of the whole network
+    statistics.reduce(SpikeExchange());
+    EXPECT_EQ(6, statistics.getNbSpikes());
+    EXPECT_EQ(4, statistics.getHistogram()[0]);
+    EXPECT_NEAR(0.5, statistics.getCV(1), 1e-12);
+
+    //Header, 3 bins and 3 neurons
+    std::ostringstream out;
+    SpikeFileHeader header = {0.1, 3, 5, 2, 1, 2};
+    statistics.write(out, header);
+    std::string lines(out.str());
+    EXPECT_EQ(17, std::count(lines.begin(), lines.end(), '\n'));
+}
+
+/**
+ * Test the CSR format of Connectivity and its transposition : the sources of each neuron become the targets of each neuron, sorted by increasing index
+ */
+TEST (Connectivity, transpose){
+
+    //Sources of each of the 4 neurons (neuron 0 receives from 2 and 3, neuron 1 from 0, ...)
+    Connectivity sources(std::vector< std::vector<size_t> >({{2,3},{0},{},{0,3,0}}));
+    EXPECT_EQ(4, sources.size());
+    EXPECT_EQ(6, sources.getNbSynapses());
+
+    Connectivity targets(sources.transpose(4));
+    EXPECT_EQ(4, targets.size());
+    EXPECT_EQ(6, targets.getNbSynapses());
+
+    //Neuron 0 is a source of 1 and twice of 3
+    ASSERT_EQ(3, targets[0].size());
+    EXPECT_EQ(1, targets[0][0]);
+    EXPECT_EQ(3, targets[0][1]);
+    EXPECT_EQ(3, targets[0][2]);
+    //Neuron 1 has no target
+    EXPECT_EQ(0, targets[1].size());
+    //Neuron 2 is a source of 0
+    ASSERT_EQ(1, targets[2].size());
+    EXPECT_EQ(0, targets[2][0]);
+    //Neuron 3 is a source of 0 and 3
+    ASSERT_EQ(2, targets[3].size());
+    EXPECT_EQ(0, targets[3][0]);
+    EXPECT_EQ(3, targets[3][1]);
+}
+
+/**
+ * Test that the parallel generation of the connections only depends on the seed : 1 thread and 3 threads give the same connections, each neuron receives the right number of sources and the lists of targets are sorted
+ */
+TEST (ConnectivityGenerator, deterministic){
+
+    //3000 neurons : 3 blocks, the last one incomplete
+    ConnectivityGenerator generator1(2400, 600, 0.1, 7);
+    generator1.setNbThreads(1);
+    ConnectivityGenerator generator3(2400, 600, 0.1, 7);
+    generator3.setNbThreads(3);
+    Connectivity connections1(generator1.generate());
+    Connectivity connections3(generator3.generate());
+
+    EXPECT_EQ(3u, generator3.getTimings().nbThreads);
+    ASSERT_EQ(3000u, connections1.size());
+    ASSERT_EQ(3000u*(240+60), connections1.getNbSynapses());
+    ASSERT_EQ(connections1.getNbSynapses(), connections3.getNbSynapses());
+
+    std::vector<size_t> nbExcitatorySources(3000, 0), nbInhibitorySources(3000, 0);
+    for(size_t source(0) ; source < connections1.size() ; ++source){
+        ASSERT_EQ(connections1[source].size(), connections3[source].size());
+        for(size_t k(0) ; k < connections1[source].size() ; ++k){
+            EXPECT_EQ(connections1[source][k], connections3[source][k]);
+            if(k > 0){
+                EXPECT_LE(connections1[source][k-1], connections1[source][k]);
+            }
+            if(source < 2400)
+                ++nbExcitatorySources[connections1[source][k]];
+            else
+                ++nbInhibitorySources[connections1[source][k]];
+        }
+    }
+    for(size_t idx(0) ; idx < 3000 ; ++idx){
+        EXPECT_EQ(240u, nbExcitatorySources[idx]);
+        EXPECT_EQ(60u, nbInhibitorySources[idx]);
+    }
+
+    //Another seed gives other connections
+    ConnectivityGenerator generator2(2400, 600, 0.1, 8);
+    Connectivity connections2(generator2.generate());
+    size_t nbDifferences(0);
+    for(size_t source(0) ; source < 3000 ; ++source)
+        nbDifferences += connections1[source].size() != connections2[source].size();
+    EXPECT_GT(nbDifferences, 0u);
+
+    //The parallel transposition gives the same result as the sequential one
+    Connectivity transposed1(connections1.transpose(3000));
+    Connectivity transposed4(connections1.transpose(3000, 4));
+    for(size_t source(0) ; source < 3000 ; ++source){
+        ASSERT_EQ(transposed1[source].size(), transposed4[source].size());
+        for(size_t k(0) ; k < transposed1[source].size() ; ++k)
+            EXPECT_EQ(transposed1[source][k], transposed4[source][k]);
+    }
+}
+
+/**
+ * Test that a process of a distributed simulation only generates the connections that reach its neurons, and that they are the ones of the whole network
+ */
+TEST (ConnectivityGenerator, processPart){
+
+    //5000 neurons in 3 processes of 2 threads : the process 1 has the ranges 2 and 3, from 1666 to 3333, which cut the blocks
+    Network whole(true, 5, 2, 5000, 2024, 7);
+    whole.createNetwork();
+    Network part(true, 5, 2, 5000, 2024, 7);
+    part.setNbThreads(2);
+    part.setExchange(SpikeExchange(1, 3));
+    EXPECT_TRUE(part.getExchange().isDistributed());
+    EXPECT_EQ(6u, part.getNbRanges());
+    part.createNetwork();
+
+    ASSERT_EQ(5000u, part.neuronConnections_.size());
+    EXPECT_EQ((3333u - 1666u)*(400 + 100), part.neuronConnections_.getNbSynapses());
+    for(size_t source(0) ; source < 5000 ; ++source){
+        std::vector<uint32_t> expected;
+        for(auto target : whole.neuronConnections_[source]){
+            if(target >= 1666 and target < 3333)
+                expected.push_back(target);
+        }
+        Connectivity::TargetRange targets(part.neuronConnections_[source]);
+        ASSERT_EQ(expected.size(), targets.size());
+        for(size_t k(0) ; k < expected.size() ; ++k)
+            EXPECT_EQ(expected[k], targets[k]);
+    }
+
+    //The part of a process can't be saved
+    EXPECT_THROW(part.saveCheckpoint("../result/test_part.bin"), std::string);
+}
+
+/**
+ * Test that the connections kept in a ConnectivityCache are read back identically, that another seed has its own file and that a damaged file is generated again
+ */
+TEST (ConnectivityCache, reuse){
+
+    ConnectivityCache cache("../result");
+    ConnectivityGenerator generator(800, 200, 0.1, 5);
+    std::string fileName(cache.getFileName(generator));
+    std::remove(fileName.c_str());
+
+    //The first time, the connections are generated and written in the cache
+    Connectivity generated(cache.get(generator));
+    EXPECT_FALSE(cache.wasLoaded());
+
+    //The second time, they are read from the file
+    ConnectivityGenerator sameKey(800, 200, 0.1, 5);
+    Connectivity loaded(cache.get(sameKey));
+    EXPECT_TRUE(cache.wasLoaded());
+    ASSERT_EQ(generated.size(), loaded.size());
+    ASSERT_EQ(generated.getNbSynapses(), loaded.getNbSynapses());
+    for(size_t source(0) ; source < generated.size() ; ++source){
+        ASSERT_EQ(generated[source].size(), loaded[source].size());
+        for(size_t k(0) ; k < generated[source].size() ; ++k)
+            EXPECT_EQ(generated[source][k], loaded[source][k]);
+    }
+
+    ConnectivityGenerator otherSeed(800, 200, 0.1, 6);
+    EXPECT_NE(fileName, cache.getFileName(otherSeed));
+
+    //A damaged file is replaced
+    {
+        std::ofstream damaged(fileName, std::ios::binary | std::ios::trunc);
+        damaged << "not a cache";
+    }
+    Connectivity regenerated(cache.get(generator));
+    EXPECT_FALSE(cache.wasLoaded());
+    EXPECT_EQ(generated.getNbSynapses(), regenerated.getNbSynapses());
+    cache.get(generator);
+    EXPECT_TRUE(cache.wasLoaded());
+
+    //A file with a target out of the network, at the end of the array of the targets, is replaced
+    {
+        std::fstream damaged(fileName, std::ios::binary | std::ios::in | std::ios::out);
+        damaged.seekp(-static_cast<std::streamoff>(sizeof(uint32_t)), std::ios::end);
+        uint32_t target(1000);
+        damaged.write(reinterpret_cast<const char*>(&target), sizeof(target));
+    }
+    regenerated = cache.get(generator);
+    EXPECT_FALSE(cache.wasLoaded());
+    EXPECT_EQ(generated[999][generated[999].size()-1], regenerated[999][regenerated[999].size()-1]);
+    cache.get(generator);
+    EXPECT_TRUE(cache.wasLoaded());
+
+    std::remove(fileName.c_str());
+}
+
+/**
+ * Test that the spikes written by a SpikeRecorder (with a small buffer, written several times) are read back identically by a SpikeReader, with the header
+ */
+TEST (SpikeRecorder, writeAndRead){
+
+    SpikeFileHeader header = {0.1, 12500, 4.5, 0.9, 1234, 5678};
+    {
+        //Buffer of 3 spikes : the file is written every 3 spikes and at the destruction
+        SpikeRecorder recorder(3);
+        recorder.open("../result/test_spikes.bin", header);
+        for(uint32_t i(0) ; i < 10 ; ++i)
+            recorder.record(100+i, 2*i);
+        EXPECT_EQ(10, recorder.getNbSpikes());
+    }
+
+    SpikeReader reader("../result/test_spikes.bin");
+    EXPECT_EQ(0.1, reader.getHeader().h);
+    EXPECT_EQ(12500, reader.getHeader().nbNeurons);
+    EXPECT_EQ(4.5, reader.getHeader().g);
+    EXPECT_EQ(0.9, reader.getHeader().eta);
+    EXPECT_EQ(1234, reader.getHeader().seed);
+    EXPECT_EQ(5678, reader.getHeader().connectivitySeed);
+
+    SpikeRecord spike;
+    for(uint32_t i(0) ; i < 10 ; ++i){
+        ASSERT_TRUE(reader.next(spike));
+        EXPECT_EQ(100+i, spike.step);
+        EXPECT_EQ(2*i, spike.neuron);
+    }
+    EXPECT_FALSE(reader.next(spike));
+
+    //A file that is not a spike file is rejected
+    EXPECT_THROW(SpikeReader("../param.in"), std::string);
+}
+
+/**
+ * Test that the files of the processes of a distributed simulation are merged by timeStep, in the order of the files for the spikes of the same timeStep, and that files of different simulations are rejected
+ */
+TEST (SpikeRecorder, merge){
+
+    SpikeFileHeader header = {0.1, 100, 5, 2, 7, 2024};
+    std::vector<std::string> inputs = {SpikeExchange::getRankFileName("../result/test_merge.bin", 0), SpikeExchange::getRankFileName("../result/test_merge.bin", 1)};
+    EXPECT_EQ("../result/test_merge.bin.1", inputs[1]);
+    {
+        SpikeRecorder rank0, rank1;
+        rank0.open(inputs[0], header);
+        rank1.open(inputs[1], header);
+        rank0.record(1, 3);
+        rank0.record(1, 20);
+        rank0.record(4, 8);
+        rank1.record(1, 60);
+        rank1.record(2, 51);
+        rank1.record(4, 99);
+    }
+
+    EXPECT_EQ(6u, SpikeRecorder::merge(inputs, "../result/test_merge.bin"));
+    SpikeReader reader("../result/test_merge.bin");
+    EXPECT_EQ(2024u, reader.getHeader().connectivitySeed);
+    const uint32_t expected[6][2] = {{1, 3}, {1, 20}, {1, 60}, {2, 51}, {4, 8}, {4, 99}};
+    SpikeRecord spike;
+    for(auto const& record : expected){
+        ASSERT_TRUE(reader.next(spike));
+        EXPECT_EQ(record[0], spike.step);
+        EXPECT_EQ(record[1], spike.neuron);
+    }
+    EXPECT_FALSE(reader.next(spike));
+
+    //The file of another seed is not merged
+    header.seed = 8;
+    {
+        SpikeRecorder other;
+        other.open(inputs[1], header);
+    }
+    EXPECT_THROW(SpikeRecorder::merge(inputs, "../result/test_merge.bin"), std::string);
+
+    for(auto const& input : inputs)
+        std::remove(input.c_str());
+    std::remove("../result/test_merge.bin");
+}
+
+/**
+ * Test the lock-free queue between two threads : all the elements pushed by the producer are popped by the consumer, in the same order, even if the queue is often full
+ */
+TEST (SpscQueue, producerConsumer){
+
+    //The capacity is rounded up to a power of 2
+    SpscQueue<uint32_t> queue(50);
+    EXPECT_EQ(64, queue.capacity());
+
+    const uint32_t nb(20000);
+    std::thread producer([&queue, nb]{
+        for(uint32_t i(0) ; i < nb ; ++i){
+            while(!queue.push(i))
+                std::this_thread::yield();
+        }
+    });
+
+    std::vector<uint32_t> received;
+    uint32_t chunk[3];
+    while(received.size() < nb){
+        size_t nbPopped(queue.pop(chunk, 3));
+        for(size_t i(0) ; i < nbPopped ; ++i)
+            received.push_back(chunk[i]);
+        if(nbPopped == 0)
+            std::this_thread::yield();
+    }
+    producer.join();
+
+    EXPECT_EQ(0, queue.size());
+    for(uint32_t i(0) ; i < nb ; ++i)
+        ASSERT_EQ(i, received[i]);
+}
+
+/**
+ * Test the asynchronous mode of SpikeRecorder, with a tiny queue so that the simulation thread has to wait : all the spikes are written in order
+ */
+TEST (SpikeRecorder, asynchronous){
+
+    SpikeFileHeader header = {0.1, 100, 5, 2, 1, 2};
+    const uint32_t nb(50000);
+    {
+        SpikeRecorder recorder(1024);
+        recorder.setAsynchronous(true);
+        recorder.open("../result/test_spikes_async.bin", header);
+        for(uint32_t i(0) ; i < nb ; ++i)
+            recorder.record(i, i%100);
+        recorder.close();
+
+        EXPECT_EQ(nb, recorder.getNbSpikes());
+        EXPECT_GT(recorder.getStatistics().nbWrites, 0);
+    }
+
+    SpikeReader reader("../result/test_spikes_async.bin");
+    EXPECT_EQ(100, reader.getHeader().nbNeurons);
+    SpikeRecord spike;
+    for(uint32_t i(0) ; i < nb ; ++i){
+        ASSERT_TRUE(reader.next(spike));
+        ASSERT_EQ(i, spike.step);
+        ASSERT_EQ(i%100, spike.neuron);
+    }
+    EXPECT_FALSE(reader.next(spike));
+}
+
+/**
+ * Chi-square statistic of a sample against a Poisson distribution. The values with an expected count lower than 5 are grouped in the last class
+ * @param counts : counts[k] is the number of draws equal to k
+ * @param mean is the mean of the Poisson distribution
+ * @param nbDraws is the number of draws
+ * @param nbClasses receives the number of classes used
+ * @return the chi-square statistic
+ */
+double chiSquarePoisson(std::vector<unsigned long int> const& counts, double const& mean, unsigned long int const& nbDraws, size_t& nbClasses){
+    
+    double chi2(0), probability(exp(-mean)), cumulated(0);
+    unsigned long int observedCumulated(0);
+    nbClasses = 0;
+    for(size_t k(0) ; k < counts.size() and (1-cumulated-probability)*nbDraws >= 5 ; ++k){
+        double expected(probability*nbDraws);
+        chi2 += (counts[k]-expected)*(counts[k]-expected)/expected;
+        cumulated += probability;
+        observedCumulated += counts[k];
+        probability *= mean/(k+1);
+        ++nbClasses;
+    }
+    //The tail
+    double expected((1-cumulated)*nbDraws), observed(nbDraws-observedCumulated);
+    chi2 += (observed-expected)*(observed-expected)/expected;
+    ++nbClasses;
+    
+    return chi2;
+}
+
+/**
+ * Statistical validation of BackgroundNoise against std::poisson_distribution : for the means of the 4 regimes of the figure 8 (0.9, 2, 4) and a larger one, the two samples have the Poisson mean and variance and pass a chi-square test
+ */
+TEST (BackgroundNoise, poisson){
+    
+    const unsigned long int nbDraws(1000000);
+    std::vector<double> means = {0.9, 2, 4, 10};
+    
+    for(auto mean : means){
+        BackgroundNoise noise(mean, 7);
+        std::mt19937 gen(7);
+        std::poisson_distribution<> reference(mean);
+        
+        std::vector<unsigned long int> countsNoise(100,0), countsReference(100,0);
+        double sumNoise(0), sumSquaresNoise(0), sumReference(0), sumSquaresReference(0);
+        std::vector<unsigned int> draws(nbDraws);
+        noise.fill(draws.data(), nbDraws);
+        
+        for(unsigned long int i(0) ; i < nbDraws ; ++i){
+            unsigned int x(draws[i]), y(reference(gen));
+            ASSERT_LT(x, 100);
+            ++countsNoise[x];
+            ++countsReference[y];
+            sumNoise += x;
+            sumSquaresNoise += x*x;
+            sumReference += y;
+            sumSquaresReference += y*y;
+        }
+        
+        //Mean and variance equal to the mean of the distribution, for both generators (standard error about sqrt(mean/nbDraws))
+        double meanNoise(sumNoise/nbDraws), meanReference(sumReference/nbDraws);
+        EXPECT_NEAR(mean, meanNoise, 5*sqrt(mean/nbDraws));
+        EXPECT_NEAR(mean, meanReference, 5*sqrt(mean/nbDraws));
+        EXPECT_NEAR(mean, sumSquaresNoise/nbDraws - meanNoise*meanNoise, 0.01*mean);
+        EXPECT_NEAR(mean, sumSquaresReference/nbDraws - meanReference*meanReference, 0.01*mean);
+        
+        //Chi-square test at 0.1% : both samples are accepted as Poisson distributed
+        size_t nbClassesNoise, nbClassesReference;
+        double chi2Noise(chiSquarePoisson(countsNoise, mean, nbDraws, nbClassesNoise));
+        double chi2Reference(chiSquarePoisson(countsReference, mean, nbDraws, nbClassesReference));
+        //Critical value of the chi-square at 0.1% for nbClasses-1 degrees of freedom (Wilson-Hilferty approximation)
+        double df(nbClassesNoise-1);
+        double critical(df*pow(1 - 2/(9*df) + 3.09*sqrt(2/(9*df)), 3));
+        EXPECT_EQ(nbClassesNoise, nbClassesReference);
+        EXPECT_LT(chi2Noise, critical);
+        EXPECT_LT(chi2Reference, critical);
+    }
+    
+    //Two generators with the same seed and stream give the same draws, other streams give other draws
+    BackgroundNoise noise1(2, 42, 1), noise2(2, 42, 1), noise3(2, 42, 2);
+    bool different(false);
+    for(size_t i(0) ; i < 1000 ; ++i){
+        unsigned int x(noise1()), z(noise3());
+        EXPECT_EQ(x, noise2());
+        different = different or x != z;
+    }
+    EXPECT_TRUE(different);
+}
+
 //! Class NetTest
 /*!
  This class heritate from Network, but has a different update method and a method to specifically create and connect 2 neurons, for the purpose of the tests.
@@ -207,15 +949,10 @@ public:
      */
     void connectTwoNeurons(){
         
-        //Ensure that the vector neurons has a length of 2
-        neurons.resize(2);
         //Create 2 neurons one excitatory and one inhibitory
-        neurons[0] = new Neuron (true);
-        neurons[1] = new Neuron (false);
-        //Ensure that the neuronConnections_ has a length of 2
-        neuronConnections_.resize(2);
-        //Put neuron 1 in target of neuron 0
-        neuronConnections_[0].push_back(1);
+        neurons.resize(2,1);
+        //Put neuron 1 in target of neuron 0, neuron 1 has no target
+        neuronConnections_ = Connectivity(std::vector< std::vector<size_t> >({{1},{}}));
         
     }
     
@@ -230,17 +967,11 @@ public:
         for(size_t NeuronIndice(0) ; NeuronIndice < getNbNeurons() ; ++NeuronIndice){
             
             //update each neuron
-            bool spike(neurons[NeuronIndice]->update(getJidxToRead(),getGlobalClock()));
+            bool spike(neurons.update(NeuronIndice,getJidxToRead(),getGlobalClock()));
             if(spike){
                 timeSpikes[NeuronIndice] = getGlobalClock();
-                
-                for(auto targetIndice : neuronConnections_[NeuronIndice] ){
-                    if(neurons[NeuronIndice]->getIsExcitatory())
-                        //if has spiked, will send an action potential
-                        neurons[targetIndice]->jToAdd_[getJidxToWrite()] += 1;
-                    else
-                        neurons[targetIndice]->jToAdd_[getJidxToWrite()] += -getG();
-                }
+                //if has spiked, will send an action potential
+                sendSpike(NeuronIndice);
             }
         }
         
@@ -258,7 +989,7 @@ TEST (TwoNeurons, spikeTransmissionFromExcitatory){
 
     NetTest net;
     net.connectTwoNeurons();
-    net.neurons[0]->setI(1.01);
+    net.neurons.setI(0,1.01);
 
     bool spike1(false), spike2(false);
     int counter1(0);
@@ -282,7 +1013,7 @@ TEST (TwoNeurons, spikeTransmissionFromExcitatory){
 
     //If they don't spike, the membrane potential of neuron 2 stays at 0mV
     EXPECT_EQ(0, counter1);
-    EXPECT_EQ(0, net.neurons[1]->getMembranePotential());
+    EXPECT_EQ(0, net.neurons.getMembranePotential(1));
 
     timeSpikes = net.update_for_test();
         if(timeSpikes[0]!=0){
@@ -322,7 +1053,7 @@ TEST (TwoNeurons, spikeTransmissionFromExcitatory){
     //Neuron1 receives the spike at time 92.4 + 1.5 = 93.9 (+0.1, because it updates at the end)
     EXPECT_NEAR(94, net.getGlobalClock()*h, 1E-3);
     //The membrane potential of neuron1 should be 0.1 because it receives the amplitude j from neuron0
-    EXPECT_EQ(0.1, net.neurons[1]->getMembranePotential());
+    EXPECT_EQ(0.1, net.neurons.getMembranePotential(1));
 
 }
 
@@ -333,8 +1064,8 @@ TEST (TwoNeurons, spikeTransmissionFromInhibitor){
 
     NetTest net;
     net.connectTwoNeurons();
-    net.neurons[0]->setIsExcitatory(false);
-    net.neurons[0]->setI(1.01);
+    net.neurons.setIsExcitatory(0,false);
+    net.neurons.setI(0,1.01);
 
     bool spike1(false), spike2(false);
     int counter1(0);
@@ -359,7 +1090,7 @@ TEST (TwoNeurons, spikeTransmissionFromInhibitor){
 
     //If they don't spike, the membrane potential of neuron 2 stays at 0mV
     EXPECT_EQ(0, counter1);
-    EXPECT_EQ(0, net.neurons[1]->getMembranePotential());
+    EXPECT_EQ(0, net.neurons.getMembranePotential(1));
 
     timeSpikes =net.update_for_test();
     if(timeSpikes[0]!=0){
@@ -400,41 +1131,41 @@ TEST (TwoNeurons, spikeTransmissionFromInhibitor){
     //Neuron1 receives the spike at time 92.4 + 1.5 = 93.9 (+0.1, because it updates at the end)
     EXPECT_NEAR(94, net.getGlobalClock()*h, 1E-3);
     //The membrane potential of neuron1 should be -0.5 because it receives the amplitude j from neuron0
-    EXPECT_EQ(-0.5, net.neurons[1]->getMembranePotential());
+    EXPECT_EQ(-0.5, net.neurons.getMembranePotential(1));
 
 
     //Test the input from inhibitory with g=3
     NetTest net1(3,2,2);
     net1.connectTwoNeurons();
-    net1.neurons[0]->setIsExcitatory(false);
-    net1.neurons[0]->setI(1.01);
+    net1.neurons.setIsExcitatory(0,false);
+    net1.neurons.setI(0,1.01);
     
     for(size_t i(0); i < 940 ; ++i)
         net1.update_for_test();
     //Ji should be -0.3
-    EXPECT_NEAR(-0.3, net1.neurons[1]->getMembranePotential(),1E-3);
+    EXPECT_NEAR(-0.3, net1.neurons.getMembranePotential(1),1E-3);
     
     //Test the input from inhibitory with g=6
     NetTest net2(6,4,2);
     net2.connectTwoNeurons();
-    net2.neurons[0]->setIsExcitatory(false);
-    net2.neurons[0]->setI(1.01);
+    net2.neurons.setIsExcitatory(0,false);
+    net2.neurons.setI(0,1.01);
     
     for(size_t i(0); i < 940 ; ++i)
         net2.update_for_test();
     //Ji should be -0.3
-    EXPECT_NEAR(-0.6, net2.neurons[1]->getMembranePotential(),1E-3);
+    EXPECT_NEAR(-0.6, net2.neurons.getMembranePotential(1),1E-3);
     
     //Test the input from inhibitory with g=4.5
     NetTest net3(4.5,0.9,2);
     net3.connectTwoNeurons();
-    net3.neurons[0]->setIsExcitatory(false);
-    net3.neurons[0]->setI(1.01);
+    net3.neurons.setIsExcitatory(0,false);
+    net3.neurons.setI(0,1.01);
     
     for(size_t i(0); i < 940 ; ++i)
         net3.update_for_test();
     //Ji should be -0.45
-    EXPECT_NEAR(-0.45, net3.neurons[1]->getMembranePotential(),1E-3);
+    EXPECT_NEAR(-0.45, net3.neurons.getMembranePotential(1),1E-3);
 }
 
 /**
@@ -521,9 +1252,9 @@ TEST(Neuron, variables){
     //Check G and Vext for one of those neurons
     EXPECT_EQ(5,net.getG());
     //Neuron 1 should be inhibitory
-    EXPECT_TRUE(net.neurons[1]->getIsExcitatory());
+    EXPECT_TRUE(net.neurons.getIsExcitatory(1));
     //Neuron 99 should be inhibitory
-    EXPECT_FALSE(net.neurons[99]->getIsExcitatory());
+    EXPECT_FALSE(net.neurons.getIsExcitatory(99));
 
     //Create a network with g=3, eta=2 and 10 neurons, without backgroundNoise
     Network net2(false, 3,2,100);
@@ -532,11 +1263,549 @@ TEST(Neuron, variables){
     //Check G and Vext for one of those neurons
     EXPECT_EQ(3,net2.getG());
     //Neuron 1 should be inhibitory
-    EXPECT_TRUE(net2.neurons[1]->getIsExcitatory());
+    EXPECT_TRUE(net2.neurons.getIsExcitatory(1));
     //Neuron 99 should be inhibitory
-    EXPECT_FALSE(net2.neurons[99]->getIsExcitatory());
+    EXPECT_FALSE(net2.neurons.getIsExcitatory(99));
+
+    
+    
+}
+
 
+/**
+ * Test that the threaded update is deterministic : two networks with the same connections, the same seed and the same number of threads have exactly the same membrane potentials. Without background noise, the result doesn't depend on the number of threads either
+ */
+TEST(Network, threads){
+    
+    //Two networks of 500 neurons with background noise, g=5, eta=2, updated by 3 threads
+    Network net1(true, 5, 2, 500);
+    net1.createNetwork();
+    net1.setNoiseSeed(42);
+    net1.setNbThreads(3);
+    
+    Network net2(true, 5, 2, 500);
+    net2.createNetwork();
+    net2.neuronConnections_ = net1.neuronConnections_;
+    net2.setNoiseSeed(42);
+    net2.setNbThreads(3);
+    
+    net1.updateNetwork(0, 1000);
+    net2.updateNetwork(0, 1000);
+    
+    EXPECT_EQ(1000, net1.getGlobalClock());
+    EXPECT_EQ(net1.getJidxToRead(), net2.getJidxToRead());
+    for(size_t i(0) ; i < net1.getNbNeurons() ; ++i)
+        EXPECT_EQ(net1.neurons.getMembranePotential(i), net2.neurons.getMembranePotential(i));
     
+    //Without background noise, 1 thread and 4 threads give the same result. Some neurons receive an external current to create activity
+    Network net3(false, 5, 2, 500);
+    net3.createNetwork();
+    Network net4(false, 5, 2, 500);
+    net4.createNetwork();
+    net4.neuronConnections_ = net3.neuronConnections_;
+    net4.setNbThreads(4);
+    for(size_t i(0) ; i < 500 ; i += 3){
+        net3.neurons.setI(i, 1.05);
+        net4.neurons.setI(i, 1.05);
+    }
+    
+    net3.updateNetwork(0, 2000);
+    net4.updateNetwork(0, 2000);
     
+    for(size_t i(0) ; i < net3.getNbNeurons() ; ++i)
+        EXPECT_EQ(net3.neurons.getMembranePotential(i), net4.neurons.getMembranePotential(i));
+}
+
+/**
+ * Test a small parameter sweep : the grid, the sharing of the connections and the summary
+ */
+TEST(ParameterSweep, grid){
+
+    //The copies of a Connectivity share its arrays
+    Connectivity connections(std::vector< std::vector<size_t> >({{1,2},{0}}));
+    Connectivity copy(connections);
+    EXPECT_EQ(connections[0].begin(), copy[0].begin());
+
+    SimulationConfig config;
+    const char* argv[] = {"Neuron", "--neurons", "200", "--start", "0", "--stop", "100", "--seed", "7", "--sweep-g", "3,6", "--sweep-eta", "0,2,4", "--sweep-jobs", "2"};
+    config.parseArguments(15, argv);
+    config.validate();
+    EXPECT_TRUE(config.isSweep());
+
+    ParameterSweep sweep(config);
+    ASSERT_EQ(6, sweep.getNbPoints());
+    sweep.run(std::cout);
+
+    std::vector<SweepResult> const& results(sweep.getResults());
+    EXPECT_EQ(3, results[0].g);
+    EXPECT_EQ(0, results[0].eta);
+    EXPECT_EQ(6, results[5].g);
+    EXPECT_EQ(4, results[5].eta);
+    for(auto const& result : results){
+        EXPECT_EQ(7, result.noiseSeed);
+        EXPECT_TRUE(result.spikesFileName.empty());
+    }
+    EXPECT_EQ(-1, results[0].cv);
+    EXPECT_LT(0, results[2].cv);
+    //Without background noise the network stays silent, with a strong one it spikes
+    EXPECT_EQ(0, results[0].nbSpikes);
+    EXPECT_LT(0, results[2].nbSpikes);
+    EXPECT_LT(results[5].rate, results[2].rate);
+
+    std::ostringstream summary;
+    sweep.writeSummary(summary);
+    std::string lines(summary.str());
+    EXPECT_EQ(7, std::count(lines.begin(), lines.end(), '\n'));
+
+    EXPECT_EQ("../result/spikes_g4.5_eta0.9.bin", ParameterSweep::getPointFileName("../result/spikes.bin", 4.5, 0.9));
+}
+
+/**
+ * Test that a network restored from a checkpoint continues exactly like the network that was saved, with the background noise
+ */
+TEST(Network, checkpoint){
+
+    Network net1(true, 5, 2, 300);
+    net1.setNbThreads(2);
+    net1.setNoiseSeed(11);
+    net1.setSpikesFileName("");
+    net1.createNetwork();
+    net1.updateNetwork(0, 150);
+    net1.saveCheckpoint("../result/test_checkpoint.bin");
+
+    //A network with other parameters takes all the ones of the checkpoint
+    Network net2(false, 3, 1, 100);
+    net2.restoreCheckpoint("../result/test_checkpoint.bin");
+    EXPECT_EQ(net1.getGlobalClock(), net2.getGlobalClock());
+    EXPECT_EQ(net1.getJidxToRead(), net2.getJidxToRead());
+    EXPECT_EQ(2, net2.getNbThreads());
+    EXPECT_EQ(5, net2.getG());
+    EXPECT_EQ(net1.neuronConnections_.getNbSynapses(), net2.neuronConnections_.getNbSynapses());
+    net2.setSpikesFileName("");
+
+    net1.updateNetwork(0, 400);
+    net2.updateNetwork(0, 400);
+    EXPECT_LT(0, net1.getNbRecordedSpikes());
+    EXPECT_EQ(net1.getNbRecordedSpikes(), net2.getNbRecordedSpikes());
+    for(size_t i(0) ; i < 300 ; ++i)
+        ASSERT_EQ(net1.neurons.getMembranePotential(i), net2.neurons.getMembranePotential(i));
+
+    //The restored network saves its state in the file it uses in place, like a run resumed from and saved to the same checkpoint
+    net2.saveCheckpoint("../result/test_checkpoint.bin");
+    Network net3(false, 3, 1, 100);
+    net3.restoreCheckpoint("../result/test_checkpoint.bin");
+    std::remove("../result/test_checkpoint.bin");
+    net3.setSpikesFileName("");
+    net2.updateNetwork(0, 600);
+    net3.updateNetwork(0, 600);
+    EXPECT_EQ(net2.getNbRecordedSpikes(), net3.getNbRecordedSpikes());
+    for(size_t i(0) ; i < 300 ; ++i)
+        ASSERT_EQ(net2.neurons.getMembranePotential(i), net3.neurons.getMembranePotential(i));
+
+    //Not a checkpoint
+    EXPECT_THROW(net2.restoreCheckpoint("../param.in"), std::string);
+
+    //A checkpoint cut after the neurons is rejected, and the network is left as it was
+    net1.saveCheckpoint("../result/test_checkpoint.bin");
+    std::string content;
+    {
+        std::ifstream file("../result/test_checkpoint.bin", std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream cut("../result/test_checkpoint.bin", std::ios::binary | std::ios::trunc);
+        cut.write(content.data(), content.size()*3/4);
+    }
+    Network other(true, 4, 1, 200);
+    other.setNbThreads(3);
+    other.createNetwork();
+    EXPECT_THROW(other.restoreCheckpoint("../result/test_checkpoint.bin"), std::string);
+    std::remove("../result/test_checkpoint.bin");
+    EXPECT_EQ(200u, other.getNbNeurons());
+    EXPECT_EQ(200u, other.neurons.size());
+    EXPECT_EQ(4, other.getG());
+    EXPECT_EQ(3u, other.getNbThreads());
+    EXPECT_EQ(0u, other.getGlobalClock());
 }
 
+/**
+ * Golden output : a small network with fixed seeds always produces the same spike train. The number of spikes and a hash (FNV-1a) of all the spikes are locked, any change of the results of the simulation (connections, noise, membrane equation, delivery of the spikes) makes this test fail
+ */
+TEST(Network, goldenOutput){
+
+    Network net(true, 5, 2, 500, 2024, 7);
+    net.setSpikesFileName("../result/test_golden.bin");
+    net.createNetwork();
+    net.updateNetwork(0, 1000);
+    net.closeSpikesFile();
+
+    SpikeReader reader("../result/test_golden.bin");
+    EXPECT_EQ(7u, reader.getHeader().seed);
+    EXPECT_EQ(2024u, reader.getHeader().connectivitySeed);
+
+    uint64_t nbSpikes(0), hash(14695981039346656037ULL);
+    SpikeRecord spike;
+    while(reader.next(spike)){
+        ++nbSpikes;
+        for(uint32_t value : {spike.step, spike.neuron}){
+            hash = (hash ^ value)*1099511628211ULL;
+        }
+    }
+    std::remove("../result/test_golden.bin");
+
+    EXPECT_EQ(2947u, nbSpikes);
+    EXPECT_EQ(4058958508567216808ULL, hash);
+}
+
+/**
+ * Test the profile of the updates : the number of timeSteps is always counted. With NEURON_PROFILING, the spikes counted by the threads are the spikes of the run, and each of them is delivered to its targets
+ */
+TEST(Network, profile){
+
+    Network net(true, 5, 2, 500, 3, 4);
+    net.setSpikesFileName("");
+    net.setNbThreads(2);
+    net.createNetwork();
+    net.updateNetwork(0, 300);
+    net.updateNetwork(0, 500);
+
+    RunProfile const& profile(net.getProfile());
+    EXPECT_EQ(500u, profile.getNbSteps());
+    EXPECT_GT(profile.getWallTime(), 0);
+
+    std::ostringstream json;
+    profile.writeJson(json);
+    EXPECT_NE(std::string::npos, json.str().find("\"steps\": 500"));
+
+    if(RunProfile::isEnabled()){
+        //The spikes of the timeStep 0 are not recorded
+        EXPECT_GE(profile.getNbSpikes(), net.getNbRecordedSpikes());
+        EXPECT_GT(profile.getNbSynapticEvents(), profile.getNbSpikes());
+        EXPECT_GT(profile.getPhaseTime(RunProfile::Integration), 0);
+    }
+    else {
+        EXPECT_EQ(0u, profile.getNbSpikes());
+        EXPECT_EQ(0, profile.getPhaseTime(RunProfile::Integration));
+    }
+}
+
+/**
+ * Test the precisions of the network : with a g exactly representable in float, the buffers in float (MixedPrecision) give exactly the spikes and the potentials of the reference. In float, the statistics of the population stay close to the ones of the reference
+ */
+TEST(Network, precision){
+
+    Network reference(true, 5, 2, 500, 2024, 7);
+    BasicNetwork<MixedPrecision> mixed(true, 5, 2, 500, 2024, 7);
+    BasicNetwork<SinglePrecision> single(true, 5, 2, 500, 2024, 7);
+    reference.setSpikesFileName("");
+    mixed.setSpikesFileName("");
+    single.setSpikesFileName("");
+    reference.createNetwork();
+    mixed.createNetwork(reference.neuronConnections_);
+    single.createNetwork(reference.neuronConnections_);
+    reference.updateNetwork(0, 1000);
+    mixed.updateNetwork(0, 1000);
+    single.updateNetwork(0, 1000);
+
+    EXPECT_EQ(2947u, reference.getNbRecordedSpikes());
+    EXPECT_EQ(reference.getNbRecordedSpikes(), mixed.getNbRecordedSpikes());
+    for(size_t i(0) ; i < 500 ; ++i)
+        ASSERT_EQ(reference.neurons.getMembranePotential(i), mixed.neurons.getMembranePotential(i));
+    EXPECT_NEAR(reference.getNbRecordedSpikes(), single.getNbRecordedSpikes(), 0.1*reference.getNbRecordedSpikes());
+
+    //A checkpoint is only restored in its precision
+    reference.saveCheckpoint("../result/test_precision.bin");
+    EXPECT_THROW(single.restoreCheckpoint("../result/test_precision.bin"), std::string);
+    std::remove("../result/test_precision.bin");
+}
+
+/**
+ * Test the spike counters : with g = 5, the counters weighted when they are read give exactly the spikes and the potentials of the buffers, with 2 threads and in float. A checkpoint keeps its mode
+ */
+TEST(Network, spikeCounters){
+
+    Network reference(true, 5, 2, 500, 2024, 7), counters(true, 5, 2, 500, 2024, 7);
+    BasicNetwork<SinglePrecision> single(true, 5, 2, 500, 2024, 7), singleCounters(true, 5, 2, 500, 2024, 7);
+    counters.setSpikeCounters(true);
+    singleCounters.setSpikeCounters(true);
+    EXPECT_TRUE(counters.getSpikeCounters());
+    EXPECT_FALSE(reference.getSpikeCounters());
+    reference.createNetwork();
+    counters.createNetwork(reference.neuronConnections_);
+    single.createNetwork(reference.neuronConnections_);
+    singleCounters.createNetwork(reference.neuronConnections_);
+    for(auto net : {&reference, &counters}){
+        net->setSpikesFileName("");
+        net->updateNetwork(0, 1000);
+    }
+    for(auto net : {&single, &singleCounters}){
+        net->setSpikesFileName("");
+        net->updateNetwork(0, 1000);
+    }
+
+    EXPECT_EQ(2947u, counters.getNbRecordedSpikes());
+    EXPECT_EQ(single.getNbRecordedSpikes(), singleCounters.getNbRecordedSpikes());
+    for(size_t i(0) ; i < 500 ; ++i){
+        ASSERT_EQ(reference.neurons.getMembranePotential(i), counters.neurons.getMembranePotential(i));
+        ASSERT_EQ(single.neurons.getMembranePotential(i), singleCounters.neurons.getMembranePotential(i));
+    }
+
+    //With 2 threads
+    Network threads(true, 5, 0.9, 300, 1, 3), threadCounters(true, 5, 0.9, 300, 1, 3);
+    threadCounters.setSpikeCounters(true);
+    for(auto net : {&threads, &threadCounters}){
+        net->setNbThreads(2);
+        net->setSpikesFileName("");
+        net->createNetwork();
+        net->updateNetwork(0, 1500);
+    }
+    EXPECT_LT(0, threads.getNbRecordedSpikes());
+    EXPECT_EQ(threads.getNbRecordedSpikes(), threadCounters.getNbRecordedSpikes());
+    for(size_t i(0) ; i < 300 ; ++i)
+        ASSERT_EQ(threads.neurons.getMembranePotential(i), threadCounters.neurons.getMembranePotential(i));
+
+    //The network restored from the checkpoint counts the spikes too
+    counters.saveCheckpoint("../result/test_counters.bin");
+    Network restored(false, 3, 1, 100);
+    restored.restoreCheckpoint("../result/test_counters.bin");
+    std::remove("../result/test_counters.bin");
+    EXPECT_TRUE(restored.getSpikeCounters());
+    restored.setSpikesFileName("");
+    counters.updateNetwork(0, 1200);
+    restored.updateNetwork(0, 1200);
+    EXPECT_EQ(counters.getNbRecordedSpikes(), restored.getNbRecordedSpikes());
+    for(size_t i(0) ; i < 500 ; ++i)
+        ASSERT_EQ(counters.neurons.getMembranePotential(i), restored.neurons.getMembranePotential(i));
+}
+
+/**
+ * Test the pull delivery : with a g that is not exact (4.3), the spikes pulled by the targets give exactly the buffers of the push delivery, with 2 threads, with the spike counters, and when the automatic mode switches between the two
+ */
+TEST(Network, pullDelivery){
+
+    EXPECT_EQ(SpikeGather::Automatic, SpikeGather::getMode("auto"));
+    EXPECT_THROW(SpikeGather::getMode("gather"), std::string);
+
+    Network push(true, 4.3, 2, 500, 2024, 7), pull(true, 4.3, 2, 500, 2024, 7), automatic(true, 4.3, 2, 500, 2024, 7);
+    pull.setDelivery(SpikeGather::Pull);
+    automatic.setDelivery(SpikeGather::Automatic);
+    //About 1 % of the neurons spike in a timeStep : the automatic mode uses both
+    automatic.getGather().setPullThreshold(0.01);
+    push.createNetwork();
+    pull.createNetwork(push.neuronConnections_);
+    automatic.createNetwork(push.neuronConnections_);
+    for(auto net : {&push, &pull, &automatic}){
+        net->setNbThreads(2);
+        net->setSpikesFileName("");
+        net->updateNetwork(0, 1000);
+    }
+
+    //The sources are the transpose of the targets
+    EXPECT_EQ(push.neuronConnections_.getNbSynapses(), pull.getGather().getSources().getNbSynapses());
+    Connectivity::TargetRange targets(push.neuronConnections_[3]);
+    Connectivity::TargetRange sources(pull.getGather().getSources()[targets[0]]);
+    EXPECT_TRUE(std::binary_search(sources.begin(), sources.end(), 3u));
+
+    EXPECT_LT(0, push.getNbRecordedSpikes());
+    EXPECT_EQ(push.getNbRecordedSpikes(), pull.getNbRecordedSpikes());
+    EXPECT_EQ(push.getNbRecordedSpikes(), automatic.getNbRecordedSpikes());
+    //Every timeStep is pulled in the pull mode, some of them only in the automatic mode
+    EXPECT_EQ(0u, push.getNbPulledSteps());
+    EXPECT_EQ(1000u, pull.getNbPulledSteps());
+    EXPECT_LT(0u, automatic.getNbPulledSteps());
+    EXPECT_GT(1000u, automatic.getNbPulledSteps());
+    for(size_t i(0) ; i < 500 ; ++i){
+        ASSERT_EQ(push.neurons.getMembranePotential(i), pull.neurons.getMembranePotential(i));
+        ASSERT_EQ(push.neurons.getMembranePotential(i), automatic.neurons.getMembranePotential(i));
+    }
+
+    //The golden run, pulled into the spike counters
+    Network counters(true, 5, 2, 500, 2024, 7);
+    counters.setSpikeCounters(true);
+    counters.setDelivery(SpikeGather::Pull);
+    counters.setSpikesFileName("");
+    counters.createNetwork();
+    counters.updateNetwork(0, 1000);
+    EXPECT_EQ(2947u, counters.getNbRecordedSpikes());
+}
+
+/**
+ * Test the procedural connections : computed again identically from the seed, with the in-degree of the stored connections on average, the same spikes with any number of threads and after a checkpoint, and nothing stored
+ */
+TEST(Network, proceduralConnectivity){
+
+    ProceduralConnectivity connections(5000, 400 + 100, 2024);
+    EXPECT_EQ(5000u*500u, connections.getNbSynapses());
+    std::vector<uint32_t> targets(connections.getTargets(17));
+    ASSERT_EQ(500u, targets.size());
+    EXPECT_EQ(targets, ProceduralConnectivity(5000, 500, 2024).getTargets(17));
+    EXPECT_NE(targets, ProceduralConnectivity(5000, 500, 2025).getTargets(17));
+    EXPECT_NE(targets, connections.getTargets(18));
+
+    //Each neuron receives on average epsilon*nbExcitatory = 400 excitatory connections, with a binomial spread of 20
+    std::vector<unsigned int> nbExcitatorySources(5000, 0);
+    for(size_t source(0) ; source < 4000 ; ++source){
+        for(size_t k(0) ; k < connections.getNbTargets() ; ++k){
+            uint32_t target(connections.getTarget(source, k));
+            ASSERT_LT(target, 5000u);
+            ++nbExcitatorySources[target];
+        }
+    }
+    double mean(0);
+    for(auto nb : nbExcitatorySources)
+        mean += nb/5000.0;
+    EXPECT_NEAR(400, mean, 0.01);
+    EXPECT_LT(*std::max_element(nbExcitatorySources.begin(), nbExcitatorySources.end()), 500u);
+
+    //Without background noise, 1 thread and 3 threads give the same spikes, without storing any connection. Some neurons receive an external current to create activity
+    Network single(false, 5, 2, 500, 2024, 7);
+    single.setProceduralConnectivity(true);
+    single.setSpikesFileName("");
+    single.createNetwork();
+    EXPECT_EQ(0u, single.neuronConnections_.getNbSynapses());
+    EXPECT_EQ(500u*(40 + 10), single.getProceduralConnections().getNbSynapses());
+    Network threads(false, 5, 2, 500, 2024, 7);
+    threads.setProceduralConnectivity(true);
+    threads.setNbThreads(3);
+    threads.setSpikesFileName("");
+    threads.createNetwork();
+    for(size_t i(0) ; i < 500 ; i += 3){
+        single.neurons.setI(i, 1.05);
+        threads.neurons.setI(i, 1.05);
+    }
+
+    single.updateNetwork(0, 2000);
+    threads.updateNetwork(0, 2000);
+    EXPECT_LT(0u, single.getNbRecordedSpikes());
+    EXPECT_EQ(single.getNbRecordedSpikes(), threads.getNbRecordedSpikes());
+    for(size_t i(0) ; i < 500 ; ++i)
+        ASSERT_EQ(single.neurons.getMembranePotential(i), threads.neurons.getMembranePotential(i));
+
+    //The checkpoint only keeps the seed of the connections, with the background noise
+    Network noisy(true, 5, 2, 500, 2024, 7);
+    noisy.setProceduralConnectivity(true);
+    noisy.setNbThreads(2);
+    noisy.setSpikesFileName("");
+    noisy.createNetwork();
+    noisy.updateNetwork(0, 500);
+    noisy.saveCheckpoint("../result/test_procedural.bin");
+    Network restored(false, 3, 1, 100);
+    restored.restoreCheckpoint("../result/test_procedural.bin");
+    std::remove("../result/test_procedural.bin");
+    EXPECT_TRUE(restored.getProceduralConnectivity());
+    restored.setSpikesFileName("");
+    noisy.updateNetwork(0, 800);
+    restored.updateNetwork(0, 800);
+    EXPECT_LT(0u, noisy.getNbRecordedSpikes());
+    EXPECT_EQ(noisy.getNbRecordedSpikes(), restored.getNbRecordedSpikes());
+    for(size_t i(0) ; i < 500 ; ++i)
+        ASSERT_EQ(noisy.neurons.getMembranePotential(i), restored.neurons.getMembranePotential(i));
+}
+
+/**
+ * Test the compact connections : the targets decoded identically from the differences of 16 bits and the escape, damaged arrays detected, the same spikes as the stored connections with several threads in less memory, and after a checkpoint saved in the file the connections are read from
+ */
+TEST(Network, compactConnectivity){
+
+    //Differences of 16 bits, with the escape for the ones that don't fit
+    Connectivity connections(std::vector< std::vector<size_t> >({{0,3,3,70000,70001},{},{65535,200000}}));
+    CompactConnectivity compact(connections);
+    ASSERT_EQ(3u, compact.size());
+    EXPECT_EQ(7u, compact.getNbSynapses());
+    for(size_t source(0) ; source < 3 ; ++source)
+        EXPECT_EQ(std::vector<uint32_t>(connections[source].begin(), connections[source].end()), compact.getTargets(source));
+    EXPECT_EQ(4*sizeof(size_t) + 13*sizeof(uint16_t), compact.getMemoryUsage());
+    EXPECT_TRUE(compact.isValid(200001));
+    EXPECT_FALSE(compact.isValid(200000));
+
+    //Damaged arrays read from a file : an escape cut by the end of its source, decreasing offsets, a target that goes back
+    const uint16_t escape(CompactConnectivity::escape);
+    std::vector< std::vector<size_t> > damagedOffsets({{0,2,4}, {0,3,2,4}, {0,4}});
+    std::vector< std::vector<uint16_t> > damagedDeltas({{escape,5,1,2}, {1,2,3,4}, {9,escape,3,0}});
+    for(size_t k(0) ; k < damagedOffsets.size() ; ++k){
+        {
+            CheckpointWriter writer("../result/test_damaged.bin");
+            writer.write<uint64_t>(2);
+            writer.writeArray(damagedOffsets[k].data(), damagedOffsets[k].size());
+            writer.writeArray(damagedDeltas[k].data(), damagedDeltas[k].size());
+            writer.close();
+        }
+        CheckpointReader reader("../result/test_damaged.bin");
+        EXPECT_FALSE(CompactConnectivity::restore(reader).isValid(100)) << k;
+    }
+    std::remove("../result/test_damaged.bin");
+
+    //The same spikes as the stored connections, with several threads, in half the memory
+    Network stored(true, 5, 2, 500, 2024, 7);
+    stored.setNbThreads(3);
+    stored.setSpikesFileName("");
+    stored.createNetwork();
+    Network network(true, 5, 2, 500, 2024, 7);
+    network.setCompactConnectivity(true);
+    network.setNbThreads(3);
+    network.setSpikesFileName("");
+    network.createNetwork();
+    EXPECT_EQ(0u, network.neuronConnections_.getNbSynapses());
+    EXPECT_EQ(stored.neuronConnections_.getNbSynapses(), network.getCompactConnections().getNbSynapses());
+    EXPECT_LT(network.getCompactConnections().getMemoryUsage(), stored.neuronConnections_.getMemoryUsage()*6/10);
+
+    stored.updateNetwork(0, 500);
+    network.updateNetwork(0, 500);
+    EXPECT_LT(0u, network.getNbRecordedSpikes());
+    EXPECT_EQ(stored.getNbRecordedSpikes(), network.getNbRecordedSpikes());
+    for(size_t i(0) ; i < 500 ; ++i)
+        ASSERT_EQ(stored.neurons.getMembranePotential(i), network.neurons.getMembranePotential(i));
+
+    //The checkpoint keeps the compact connections
+    network.saveCheckpoint("../result/test_compact.bin");
+    Network restored(false, 3, 1, 100);
+    restored.restoreCheckpoint("../result/test_compact.bin");
+    EXPECT_TRUE(restored.getCompactConnectivity());
+    //The restored network uses its compact connections in place in the file it saves its state in
+    restored.saveCheckpoint("../result/test_compact.bin");
+    Network resaved(false, 3, 1, 100);
+    resaved.restoreCheckpoint("../result/test_compact.bin");
+    std::remove("../result/test_compact.bin");
+    EXPECT_EQ(network.getCompactConnections().getTargets(17), resaved.getCompactConnections().getTargets(17));
+    restored.setSpikesFileName("");
+    network.updateNetwork(0, 800);
+    restored.updateNetwork(0, 800);
+    EXPECT_EQ(network.getNbRecordedSpikes(), restored.getNbRecordedSpikes());
+    for(size_t i(0) ; i < 500 ; ++i)
+        ASSERT_EQ(network.neurons.getMembranePotential(i), restored.neurons.getMembranePotential(i));
+}
+
+/**
+ * Test the validation of the precisions on a small network : float and mixed reproduce the statistics of the reference, the mixed precision exactly
+ */
+TEST(PrecisionValidation, smallNetwork){
+
+    EXPECT_EQ(0, PrecisionValidation::getSynchrony(std::vector<uint32_t>(4, 3)));
+    EXPECT_EQ(1, PrecisionValidation::getSynchrony(std::vector<uint32_t>({0, 2})));
+
+    SimulationConfig config;
+    const char* argv[] = {"PrecisionCheck", "--neurons", "2000", "--start", "50", "--stop", "300", "--seed", "3", "--connectivity-seed", "5", "--precision", "float"};
+    config.parseArguments(13, argv);
+    config.validate();
+    EXPECT_EQ("float", config.getPrecision());
+
+    PrecisionValidation validation(config);
+    validation.run(std::cout);
+
+    std::vector<PrecisionResult> const& results(validation.getResults());
+    ASSERT_EQ(4, results.size());
+    EXPECT_EQ("double", results[0].name);
+    EXPECT_EQ(4u, results[1].noiseSeed);
+    EXPECT_LT(0, results[0].nbSpikes);
+    EXPECT_EQ(results[0].nbSpikes, results[3].nbSpikes);
+    EXPECT_TRUE(validation.passed());
+
+    std::ostringstream report;
+    validation.writeReport(report);
+    std::string lines(report.str());
+    EXPECT_EQ(6, std::count(lines.begin(), lines.end(), '\n'));
+
+    const char* invalid[] = {"Neuron", "--precision", "half"};
+    config.parseArguments(3, invalid);
+    EXPECT_THROW(config.validate(), std::string);
+}